@@ -0,0 +1,78 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <spaceshooter.h>
+
+#define BENCH_REPS 25 // Timed repetitions per measurement, unless --reps
+#define BENCH_WARMUP 3 // Untimed repetitions first
+#define BENCH_MIN_REP_NS 1e6 // Calibrated repetitions run at least this long
+
+/* Nanoseconds per op over the repetitions of one bench_measure */
+typedef struct {
+    double min;
+    double median;
+    double p99;
+    double mean;
+    int reps;
+    long iterations; // Ops in each repetition
+} BenchStats;
+
+/* Runs iterations ops of whatever's being measured */
+typedef void (*BenchFunc)(void *data, long iterations);
+
+/*****
+ * Benchmark helpers - bench_main.c
+ *****/
+double bench_now_ns(void);
+void bench_report(const char *name, double ns, long iterations);
+BenchStats bench_measure(BenchFunc func, void *data, long iterations);
+void bench_result(const char *name, const BenchStats *stats);
+void bench_csv(const char *fmt, ...);
+WSL_App* bench_app_create(int backend);
+void bench_app_destroy(WSL_App *app);
+void bench_renderer_info(WSL_App *app);
+
+/*****
+ * Benchmarks, each returns 0 on success
+ *****/
+int bench_rng(void); // bench_rng.c
+int bench_rng_block(void); // bench_rng.c
+int bench_trig(void); // bench_trig.c
+int bench_particles(void); // bench_particles.c
+int bench_text(void); // bench_text.c
+int bench_draw(void); // bench_draw.c
+int bench_rotate(void); // bench_rotate.c
+int bench_cpu(void); // bench_cpu.c
+int bench_tiles(void); // bench_tiles.c
+int bench_cull(void); // bench_cull.c
+int bench_clock(void); // bench_clock.c
+int bench_catchup(void); // bench_catchup.c
+int bench_tickrate(void); // bench_tickrate.c
+int bench_replay(void); // bench_replay.c
+int bench_micro(void); // bench_micro.c
+int bench_stress(void); // bench_stress.c
+int bench_autopilot(void); // bench_autopilot.c
+int bench_sims(void); // bench_sims.c
+int bench_snapshot(void); // bench_snapshot.c
+
+#endif //BENCH_H
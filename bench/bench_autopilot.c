@@ -0,0 +1,85 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define AUTOPILOT_TICKS (10 * 60 * BASE_TICK_RATE) // Ten minutes of play
+#define AUTOPILOT_HANDS_OFF 5 // Games nobody plays, to compare survival with
+#define AUTOPILOT_BUDGET 0.05 // Share of the update the bot can have
+
+int bench_autopilot(void) {
+    /*
+     * Ten minutes of the autopilot playing one game after another: what its
+     * decisions cost next to the rest of the update (it has to stay under
+     * AUTOPILOT_BUDGET), and how long it lasts next to a ship nobody flies.
+     */
+    WSL_App *app = bench_app_create(RB_CPU);
+    Autopilot *bot = NULL;
+    double share, handsoff = 0;
+    long i;
+    int g;
+
+    if(!app) return 1;
+    mt_seed(20241019);
+    bot = app->autopilot = autopilot_create();
+    app->stats = (WSL_Stats){0};
+    app->state = GS_NEW;
+    for(i = 0; i < AUTOPILOT_TICKS; i++) {
+        update(app);
+    }
+    share = 0;
+    for(g = 0; g < UP_MAX; g++) {
+        share += app->stats.phase[g];
+    }
+    share = share ? app->stats.phase[UP_AUTOPILOT] / share : 0;
+    printf("%-36s %10.2f ns/tick\n", "update",
+            (double)(app->stats.phase[UP_ENTITIES] +
+                app->stats.phase[UP_PARTICLES] + app->stats.phase[UP_CLEANUP] +
+                app->stats.phase[UP_SNAPSHOT]) / AUTOPILOT_TICKS);
+    printf("%-36s %10.2f ns/tick %9.2f%% of the update\n", "autopilot",
+            (double)app->stats.phase[UP_AUTOPILOT] / AUTOPILOT_TICKS,
+            share * 100);
+    printf("%-36s %10ld games %8.1f s a game, average score %.0f\n",
+            "autopilot play", bot->games,
+            bot->games ? (double)bot->gameticks / app->tickrate / bot->games :
+            0, bot->games ? (double)bot->totalscore / bot->games : 0);
+    app->autopilot = NULL;
+    autopilot_destroy(bot);
+
+    // Nobody at the keyboard, until the ship's gone
+    memset(app->keyboard, 0, sizeof(app->keyboard));
+    for(g = 0; g < AUTOPILOT_HANDS_OFF; g++) {
+        mt_seed(20241019 + g);
+        app->state = GS_NEW;
+        update(app);
+        for(i = 0; (i < AUTOPILOT_TICKS) && (app->state == GS_GAME); i++) {
+            update(app);
+        }
+        handsoff += i;
+    }
+    printf("%-36s %10d games %8.1f s a game\n", "hands off",
+            AUTOPILOT_HANDS_OFF,
+            handsoff / app->tickrate / AUTOPILOT_HANDS_OFF);
+    bench_app_destroy(app);
+
+    printf("Autopilot %s\n", share < AUTOPILOT_BUDGET ? "within budget" :
+            "OVER BUDGET, FAIL");
+    return share < AUTOPILOT_BUDGET ? 0 : 1;
+}
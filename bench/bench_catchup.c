@@ -0,0 +1,74 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define CATCHUP_STALL (2 * NS_PER_SEC) // Stalled this long, like a debugger
+#define CATCHUP_STEP (NS_PER_SEC / BASE_TICK_RATE) // Same step as the game loop
+
+static WSL_App* catchup_game(void) {
+    /* A game in full swing, asteroids coming in and explosions going off,
+     * stalled by a mass explosion */
+    WSL_App *app = bench_app_create(RB_SDL);
+    int i;
+    if(!app) return NULL;
+    mt_seed(20241015);
+    app->state = GS_GAME;
+    for(i = 0; i < 120; i++) {
+        if(i % 4 == 0) {
+            spawn_explosion(mt_rand(0, SCREEN_WIDTH),
+                    mt_rand(0, SCREEN_HEIGHT), app);
+        }
+        update(app);
+    }
+    for(i = 0; i < 400; i++) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                app);
+    }
+    return app;
+}
+
+static void catchup_run(const char *name, int maxsteps) {
+    /* The frame after the stall: update_steps, then draw_game */
+    WSL_App *app = catchup_game();
+    uint64_t lag = CATCHUP_STALL;
+    double start, ns;
+    int steps;
+    if(!app) return;
+    start = bench_now_ns();
+    steps = update_steps(app, &lag, CATCHUP_STEP, maxsteps);
+    draw_game(app);
+    ns = bench_now_ns() - start;
+    printf("%-24s %4d updates %10.1f ms frame %8.1f ms dropped\n", name,
+            steps, ns / NS_PER_MS, app->stats.dropped / (double)NS_PER_MS);
+    bench_app_destroy(app);
+}
+
+int bench_catchup(void) {
+    /*
+     * The first frame after a 2 second stall, catching up all the way, and
+     * held to MAX_CATCHUP_STEPS updates
+     */
+    char name[64];
+    catchup_run("no limit", 0);
+    snprintf(name, sizeof(name), "at most %d", MAX_CATCHUP_STEPS);
+    catchup_run(name, MAX_CATCHUP_STEPS);
+    return 0;
+}
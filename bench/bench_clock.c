@@ -0,0 +1,95 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define CLOCK_FRAMES 120
+#define CLOCK_WORK (5 * NS_PER_MS) // Pretend each frame takes this long
+
+typedef enum {
+    PACE_SLEEP, // Sleep the whole way to the deadline
+    PACE_SPIN, // Spin the whole way
+    PACE_HYBRID // wsl_clock_pace
+} PaceModes;
+
+static double clock_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+static void clock_run(const char *name, int mode) {
+    /* Pace CLOCK_FRAMES frames of CLOCK_WORK at 60 fps, and report how late
+     * they ended and how much CPU that took */
+    WSL_Clock clock;
+    uint64_t now, late;
+    double delta, wall, cpu;
+    int i;
+    wsl_clock_init(&clock, NS_PER_SEC / 60);
+    wall = bench_now_ns();
+    cpu = clock_cpu_ns();
+    for(i = 0; i < CLOCK_FRAMES; i++) {
+        now = wsl_clock_now();
+        while(wsl_clock_now() < now + CLOCK_WORK) {
+            // Work
+        }
+        if(mode == PACE_HYBRID) {
+            wsl_clock_pace(&clock);
+            continue;
+        }
+        // The same bookkeeping as wsl_clock_pace, waiting the other ways
+        now = wsl_clock_now();
+        if(now < clock.deadline) {
+            if(mode == PACE_SLEEP) {
+                wsl_clock_sleep(clock.deadline - now);
+            } else {
+                while(wsl_clock_now() < clock.deadline) {
+                    // Spin
+                }
+            }
+            late = wsl_clock_now() - clock.deadline;
+            clock.frames += 1;
+            delta = late - clock.mean;
+            clock.mean += delta / clock.frames;
+            clock.m2 += delta * (late - clock.mean);
+            if(late > clock.worst) clock.worst = late;
+        } else {
+            clock.missed += 1;
+        }
+        clock.deadline += clock.target;
+    }
+    wall = bench_now_ns() - wall;
+    cpu = clock_cpu_ns() - cpu;
+    printf("%-20s %8.1f us late %8.1f us jitter %8.1f us worst %3lu missed"
+            " %5.1f%% CPU\n", name, clock.mean / 1000,
+            wsl_clock_jitter_stddev(&clock) / 1000, clock.worst / 1000.0,
+            (unsigned long)clock.missed, 100 * cpu / wall);
+}
+
+int bench_clock(void) {
+    /*
+     * Frame pacing at 60 fps with 5 ms of work a frame: sleeping all the way,
+     * spinning all the way, and wsl_clock_pace's sleep then spin
+     */
+    clock_run("sleep", PACE_SLEEP);
+    clock_run("spin", PACE_SPIN);
+    clock_run("sleep + spin", PACE_HYBRID);
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+
+static void cpu_scene(WSL_App *app) {
+    /* Explosion heavy: a few hundred burst particles each, some asteroids
+     * turning through them, and the player */
+    SDL_Rect playerrect = {211, 941, 99 ,75};
+    Entity *entity = create_player(playerrect);
+    int i;
+    entity->x = (SCREEN_WIDTH / 2) - (playerrect.w / 2);
+    entity->y = SCREEN_HEIGHT - playerrect.h;
+    wsl_add_entity(app, entity);
+    for(i = 0; i < 20; i++) {
+        entity = create_asteroid();
+        entity->x = mt_rand(0, SCREEN_WIDTH);
+        entity->y = mt_rand(0, SCREEN_HEIGHT);
+        entity->angle = mt_rand(0, 71) * 5;
+        wsl_add_entity(app, entity);
+    }
+    for(i = 0; i < 100; i++) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                app);
+    }
+}
+
+static void cpu_frames(void *data, long n) {
+    long i;
+    for(i = 0; i < n; i++) {
+        draw_game(data);
+    }
+}
+
+static double cpu_frame_us(WSL_App *app, const char *name) {
+    /* Median frame time over the repetitions, printed */
+    BenchStats stats = bench_measure(&cpu_frames, app, 1);
+    printf("%-36s %10.1f us/frame median %10.1f p99\n", name,
+            stats.median / 1000, stats.p99 / 1000);
+    return stats.median;
+}
+
+static double cpu_frame_diff(SDL_Surface *a, SDL_Surface *b) {
+    /* Mean difference per color channel between two ARGB8888 frames */
+    const uint32_t *pa, *pb;
+    double sum = 0;
+    int x, y, shift, ca, cb;
+    for(y = 0; y < a->h; y++) {
+        pa = (const uint32_t*)((const uint8_t*)a->pixels + (y * a->pitch));
+        pb = (const uint32_t*)((const uint8_t*)b->pixels + (y * b->pitch));
+        for(x = 0; x < a->w; x++) {
+            for(shift = 0; shift < 24; shift += 8) {
+                ca = (pa[x] >> shift) & 0xFF;
+                cb = (pb[x] >> shift) & 0xFF;
+                sum += ca > cb ? ca - cb : cb - ca;
+            }
+        }
+    }
+    return sum / ((double)a->w * a->h * 3);
+}
+
+int bench_cpu(void) {
+    /*
+     * draw_game() on SDL's software renderer against the WSL_Raster backend,
+     * both drawing the same entities, and how far apart the frames are.
+     * WSL_Raster as the game runs it (bilinear, like the
+     * SDL_HINT_RENDER_SCALE_QUALITY "1" the SDL textures get) has to be
+     * faster. Link against a real SDL for frame times that mean anything.
+     */
+    WSL_App *sdl = bench_app_create(RB_SDL);
+    WSL_App *cpu = bench_app_create(RB_CPU);
+    WSL_RotCache *cache = NULL;
+    double sdlns, cpuns;
+    bool faster;
+    if(!sdl || !cpu) {
+        bench_app_destroy(sdl);
+        bench_app_destroy(cpu);
+        return 1;
+    }
+    mt_seed(20241004);
+    cpu_scene(sdl);
+    sdl->state = cpu->state = GS_GAME;
+    cpu->entities = sdl->entities;
+    bench_renderer_info(sdl);
+    printf("%-36s %10d entities\n", "scene", count_entities(sdl->entities));
+
+    sdlns = cpu_frame_us(sdl, "draw_game, SDL software renderer");
+    cpuns = cpu_frame_us(cpu, "draw_game, WSL_Raster (bilinear)");
+    cpu->raster->bilinear = false;
+    cpu_frame_us(cpu, "draw_game, WSL_Raster (nearest)");
+    printf("%-36s %10.2fx\n", "speedup (bilinear)", sdlns / cpuns);
+
+    // Same frame both ways: sprites turned exactly (no rotation cache), and
+    // nearest sampling like the SDL software renderer
+    cache = sdl->rotcache;
+    sdl->rotcache = NULL;
+    draw_game(sdl);
+    draw_game(cpu);
+    printf("%-36s %10.3f\n", "mean channel difference",
+            cpu_frame_diff(sdl->screen_surface, cpu->raster->surface));
+    sdl->rotcache = cache;
+
+    faster = cpuns < sdlns;
+    printf("WSL_Raster %s the SDL software renderer\n", faster ? "beats" :
+            "DOESN'T BEAT, FAIL");
+    cpu->entities = NULL; // Still owned by sdl
+    bench_app_destroy(cpu);
+    bench_app_destroy(sdl);
+    return faster ? 0 : 1;
+}
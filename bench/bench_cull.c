@@ -0,0 +1,63 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define CULL_TICKS 600
+#define CULL_EXPLOSION_EVERY 4 // Ticks between explosions
+
+int bench_cull(void) {
+    /*
+     * Run the game (no player, so nothing ends it) with asteroids coming in
+     * and explosions going off all over, some of them around the edges, and
+     * count how many entities each frame drew and culled
+     */
+    WSL_App *app = bench_app_create(RB_SDL);
+    double start, ns = 0;
+    long drawn = 0, culled = 0, live = 0;
+    int tick, most = 0, count;
+    if(!app) return 1;
+    mt_seed(20241014);
+    app->state = GS_GAME;
+
+    for(tick = 0; tick < CULL_TICKS; tick++) {
+        if(tick % CULL_EXPLOSION_EVERY == 0) {
+            spawn_explosion(mt_rand(-100, SCREEN_WIDTH + 100),
+                    mt_rand(-100, SCREEN_HEIGHT + 100), app);
+        }
+        start = bench_now_ns();
+        update(app);
+        draw_game(app);
+        ns += bench_now_ns() - start;
+        drawn += app->stats.last_drawn;
+        culled += app->stats.last_culled;
+        count = count_entities(app->entities);
+        live += count;
+        if(count > most) most = count;
+    }
+    printf("%-36s %10.1f us/tick\n", "update + draw_game",
+            ns / CULL_TICKS / 1000);
+    printf("%-36s %10.1f drawn, %.1f culled\n", "entities per frame",
+            (double)drawn / CULL_TICKS, (double)culled / CULL_TICKS);
+    printf("%-36s %10.1f average, %d most\n", "entities alive",
+            (double)live / CULL_TICKS, most);
+    bench_app_destroy(app);
+    return 0;
+}
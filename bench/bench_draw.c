@@ -0,0 +1,65 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define DRAW_FRAMES 200
+
+static void draw_scene(WSL_App *app, int explosions) {
+    /* A busy frame: the player plus a pile of explosions around the screen */
+    SDL_Rect playerrect = {211, 941, 99 ,75};
+    Entity *player = create_player(playerrect);
+    int i;
+    player->x = (SCREEN_WIDTH / 2) - (playerrect.w / 2);
+    player->y = SCREEN_HEIGHT - playerrect.h;
+    player->health = 2;
+    wsl_add_entity(app, player);
+    for(i = 0; i < explosions; i++) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                app);
+    }
+}
+
+int bench_draw(void) {
+    /*
+     * Time draw_game() with a few thousand sprites on screen and report how
+     * many draw calls it took per frame
+     */
+    WSL_App *app = bench_app_create(RB_SDL);
+    double start, ns;
+    int i, sprites = 0;
+    if(!app) return 1;
+    mt_seed(20241002);
+    draw_scene(app, 100);
+    app->state = GS_GAME;
+
+    draw_game(app); // Warm up
+    start = bench_now_ns();
+    for(i = 0; i < DRAW_FRAMES; i++) {
+        draw_game(app);
+    }
+    ns = bench_now_ns() - start;
+    sprites = app->stats.last_sprites;
+    printf("%-36s %10.1f us/frame\n", "draw_game", ns / DRAW_FRAMES / 1000);
+    printf("%-36s %10d sprites, %d draw calls\n", "per frame", sprites,
+            app->stats.last_drawcalls);
+    bench_app_destroy(app);
+    return 0;
+}
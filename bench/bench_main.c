@@ -0,0 +1,311 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+#include <stdarg.h>
+#include <time.h>
+
+typedef struct {
+    const char *name;
+    int (*run)(void);
+} Bench;
+
+static const Bench benches[] = {
+    {"rng", &bench_rng},
+    {"rngblock", &bench_rng_block},
+    {"trig", &bench_trig},
+    {"particles", &bench_particles},
+    {"text", &bench_text},
+    {"draw", &bench_draw},
+    {"rotate", &bench_rotate},
+    {"cpu", &bench_cpu},
+    {"tiles", &bench_tiles},
+    {"cull", &bench_cull},
+    {"clock", &bench_clock},
+    {"catchup", &bench_catchup},
+    {"tickrate", &bench_tickrate},
+    {"replay", &bench_replay},
+    {"micro", &bench_micro},
+    {"stress", &bench_stress},
+    {"autopilot", &bench_autopilot},
+    {"sims", &bench_sims},
+    {"snapshot", &bench_snapshot},
+};
+static const int num_benches = sizeof(benches) / sizeof(benches[0]);
+
+static int bench_reps = BENCH_REPS;
+static FILE *bench_json = NULL; // --json, results from bench_result go here
+static FILE *bench_csv_file = NULL; // --csv, rows from bench_csv go here
+static const char *bench_current = ""; // Name of the benchmark running
+static int bench_json_count = 0;
+
+double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+void bench_report(const char *name, double ns, long iterations) {
+    printf("%-36s %10.2f ns/op %12.1f Mop/s\n", name, ns / iterations,
+            (iterations / ns) * 1000.0);
+}
+
+static int bench_compare(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+BenchStats bench_measure(BenchFunc func, void *data, long iterations) {
+    /*
+     * Time func over and over: BENCH_WARMUP untimed runs, then the timed
+     * repetitions, each iterations ops long. With iterations 0 it's doubled
+     * from 1 until a run takes BENCH_MIN_REP_NS, so the clock's resolution
+     * doesn't matter. p99 is nearest rank, so it's the slowest of fewer
+     * than 100 repetitions.
+     */
+    BenchStats stats = {0};
+    double *ns = malloc(sizeof(double) * bench_reps);
+    double start, total = 0;
+    int i;
+    if(!ns) return stats;
+    if(iterations <= 0) {
+        iterations = 1;
+        while(1) {
+            start = bench_now_ns();
+            func(data, iterations);
+            if((bench_now_ns() - start >= BENCH_MIN_REP_NS) ||
+                    (iterations >= (1L << 30))) break;
+            iterations *= 2;
+        }
+    }
+    for(i = 0; i < BENCH_WARMUP; i++) {
+        func(data, iterations);
+    }
+    for(i = 0; i < bench_reps; i++) {
+        start = bench_now_ns();
+        func(data, iterations);
+        ns[i] = (bench_now_ns() - start) / iterations;
+        total += ns[i];
+    }
+    qsort(ns, bench_reps, sizeof(double), &bench_compare);
+    stats.min = ns[0];
+    stats.median = (bench_reps % 2) ? ns[bench_reps / 2] :
+        (ns[bench_reps / 2 - 1] + ns[bench_reps / 2]) / 2;
+    stats.p99 = ns[(int)ceil(0.99 * bench_reps) - 1];
+    stats.mean = total / bench_reps;
+    stats.reps = bench_reps;
+    stats.iterations = iterations;
+    free(ns);
+    return stats;
+}
+
+void bench_result(const char *name, const BenchStats *stats) {
+    /* Print a bench_measure result, and add it to the --json file */
+    printf("%-36s %10.2f ns/op median %10.2f p99 %10.2f min\n", name,
+            stats->median, stats->p99, stats->min);
+    if(!bench_json) return;
+    fprintf(bench_json, "%s\n    {\"bench\": \"%s\", \"name\": \"%s\", "
+            "\"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, "
+            "\"mean_ns\": %.3f, \"reps\": %d, \"iterations\": %ld}",
+            bench_json_count ? "," : "", bench_current, name,
+            stats->median, stats->p99, stats->min, stats->mean, stats->reps,
+            stats->iterations);
+    bench_json_count += 1;
+}
+
+void bench_csv(const char *fmt, ...) {
+    /* A line of CSV, printed and also written to the --csv file */
+    va_list args;
+    va_start(args, fmt);
+    if(bench_csv_file) {
+        va_list copy;
+        va_copy(copy, args);
+        vfprintf(bench_csv_file, fmt, copy);
+        va_end(copy);
+    }
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+WSL_App* bench_app_create(int backend) {
+    /*
+     * Just enough of a WSL_App to draw with: a software renderer on an
+     * offscreen surface (or a WSL_Raster, for RB_CPU) plus the spritesheet,
+     * background, font and made up high scores. No window, no sound, and
+     * nothing gets saved. Run from the top of the repo so assets/ can be
+     * found.
+     */
+    WSL_App *app = calloc(1, sizeof(WSL_App));
+    bool success = true;
+    if(!app) return NULL;
+    if(!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) || (TTF_Init() == -1)) {
+        printf("Unable to initialize SDL_image/SDL_ttf\n");
+        free(app);
+        return NULL;
+    }
+    app->screen_surface = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH,
+            SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    if(backend == RB_CPU) {
+        app->raster = wsl_raster_create(SCREEN_WIDTH, SCREEN_HEIGHT,
+                &app->stats);
+    } else if(app->screen_surface) {
+        app->renderer = SDL_CreateSoftwareRenderer(app->screen_surface);
+    }
+    if(!app->renderer && !app->raster) {
+        printf("Unable to create a software renderer. SDL Error: %s\n",
+                SDL_GetError());
+        success = false;
+    }
+    if(success) {
+        app->spritesheet = create_wsl_texture(app->renderer);
+        app->hud_text = create_wsl_texture(app->renderer);
+        app->font = TTF_OpenFont("assets/kenvector_future.ttf", FONT_SIZE);
+        success = wsl_texture_load(app->spritesheet, "assets/spritesheet.png") &&
+            wsl_load_background(app) && app->font;
+    }
+    if(success) {
+        app->glyphs = wsl_glyph_atlas_create(app->renderer, app->font);
+        app->textcache = wsl_text_cache_create(TEXT_CACHE_BUDGET);
+        if(app->renderer) {
+            app->batch = wsl_batch_create(app->renderer, &app->stats);
+        }
+        app->queue = wsl_render_queue_create();
+        wsl_load_rot_cache(app);
+        app->scores = malloc(sizeof(Highscore) * NUM_HIGHSCORES);
+        create_scores(app);
+        app->running = true;
+        app->state = GS_MENU;
+        app->alpha = 1.0;
+        set_tick_rate(app, BASE_TICK_RATE);
+    } else {
+        printf("Unable to load assets, run from the top of the repo\n");
+        bench_app_destroy(app);
+        app = NULL;
+    }
+    return app;
+}
+
+void bench_renderer_info(WSL_App *app) {
+    /* Which SDL the frame times are from, since they're only as good as that */
+    SDL_version linked;
+    SDL_RendererInfo info;
+    SDL_GetVersion(&linked);
+    if(!app->renderer || (SDL_GetRendererInfo(app->renderer, &info) != 0)) {
+        info.name = "none";
+    }
+    printf("%-36s %7d.%d.%d, %s renderer\n", "SDL", linked.major,
+            linked.minor, linked.patch, info.name);
+}
+
+void bench_app_destroy(WSL_App *app) {
+    Entity *entity = NULL;
+    int i;
+    if(!app) return;
+    while(app->entities) {
+        entity = app->entities;
+        app->entities = app->entities->next;
+        destroy_entity(entity);
+    }
+    if(app->scores) close_scores(app);
+    wsl_glyph_atlas_destroy(app->glyphs);
+    wsl_text_cache_destroy(app->textcache);
+    wsl_batch_destroy(app->batch);
+    wsl_render_queue_destroy(app->queue);
+    wsl_rot_cache_destroy(app->rotcache);
+    destroy_wsl_texture(app->hud_text);
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        destroy_wsl_texture(app->bg[i].tex);
+    }
+    destroy_wsl_texture(app->spritesheet);
+    if(app->font) TTF_CloseFont(app->font);
+    if(app->renderer) SDL_DestroyRenderer(app->renderer);
+    wsl_raster_destroy(app->raster);
+    if(app->screen_surface) SDL_FreeSurface(app->screen_surface);
+    wsl_pool_destroy(app->pool);
+    free(app->particles);
+    free(app);
+}
+
+static int bench_run(const Bench *bench) {
+    printf("== %s ==\n", bench->name);
+    bench_current = bench->name;
+    return bench->run();
+}
+
+int main(int argc, char **argv) {
+    /*
+     * Usage: SpaceShooterBench [--reps N] [--json FILE] [--csv FILE]
+     *        [name...]
+     * Runs the named benchmarks, or all of them if none are named. Results
+     * measured with bench_measure also go to the JSON file, to keep track of
+     * them from one build to the next, and sweeps go to the CSV file.
+     */
+    int i, j, result = 0, named = 0;
+    bool found = false;
+    for(j = 1; j < argc; j++) {
+        if((strcmp(argv[j], "--reps") == 0) && (j + 1 < argc)) {
+            bench_reps = atoi(argv[++j]);
+            if(bench_reps < 1) bench_reps = 1;
+        } else if((strcmp(argv[j], "--json") == 0) && (j + 1 < argc)) {
+            bench_json = fopen(argv[++j], "w");
+            if(!bench_json) {
+                printf("Unable to open %s\n", argv[j]);
+                return 1;
+            }
+        } else if((strcmp(argv[j], "--csv") == 0) && (j + 1 < argc)) {
+            bench_csv_file = fopen(argv[++j], "w");
+            if(!bench_csv_file) {
+                printf("Unable to open %s\n", argv[j]);
+                return 1;
+            }
+        } else {
+            argv[++named] = argv[j]; // Names shuffled down to the front
+        }
+    }
+    if(bench_json) {
+        fprintf(bench_json, "{\n  \"rng\": \"%s\",\n  \"reps\": %d,\n"
+                "  \"warmup\": %d,\n  \"results\": [", rng_name(),
+                bench_reps, BENCH_WARMUP);
+    }
+    if(!named) {
+        for(i = 0; i < num_benches; i++) {
+            result |= bench_run(&benches[i]);
+        }
+    }
+    for(j = 1; j <= named; j++) {
+        found = false;
+        for(i = 0; i < num_benches; i++) {
+            if(strcmp(argv[j], benches[i].name) == 0) {
+                result |= bench_run(&benches[i]);
+                found = true;
+            }
+        }
+        if(!found) {
+            printf("Unknown benchmark: %s\n", argv[j]);
+            result = 1;
+        }
+    }
+    if(bench_json) {
+        fprintf(bench_json, "\n  ]\n}\n");
+        fclose(bench_json);
+    }
+    if(bench_csv_file) fclose(bench_csv_file);
+    return result;
+}
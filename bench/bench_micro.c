@@ -0,0 +1,292 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define MICRO_INPUTS 1024 // Random inputs cycled through, power of two
+#define MICRO_HT_KEYS 1024 // Keys in a Vec2iHT before it's started over
+#define MICRO_PQ_SIZE 64 // Items a Vec2iPQ holds while it's pushed and popped
+
+static volatile uint64_t micro_sink; // Results go here so they aren't optimized out
+
+static const int list_sizes[] = {10, 100, 1000, 10000};
+
+typedef struct {
+    SDL_Rect rects[MICRO_INPUTS];
+    Entity *entities[MICRO_INPUTS];
+    Vec2f points[MICRO_INPUTS];
+    float t[MICRO_INPUTS];
+    Vec2i keys[MICRO_INPUTS];
+    int priorities[MICRO_INPUTS];
+    WSL_App *app; // Entity list, or a whole app for the text
+    Entity *extra; // Added and removed from the list
+    Vec2iHT *table;
+    Vec2iPQ *queue;
+    WSL_Texture *tex;
+} MicroData;
+
+/*****
+ * The ops
+ *****/
+static void micro_create_destroy(void *data, long n) {
+    SDL_Rect rect = {211, 941, 99, 75};
+    Entity *e = NULL;
+    long i;
+    for(i = 0; i < n; i++) {
+        e = create_entity(rect);
+        micro_sink += e->flags;
+        destroy_entity(e);
+    }
+}
+
+static void micro_add_remove(void *data, long n) {
+    /* Onto the end of the list, and back off it */
+    MicroData *d = data;
+    long i;
+    for(i = 0; i < n; i++) {
+        wsl_add_entity(d->app, d->extra);
+        micro_sink += (uintptr_t)wsl_remove_entity(d->app, d->extra);
+    }
+}
+
+static void micro_collision(void *data, long n) {
+    MicroData *d = data;
+    long i;
+    for(i = 0; i < n; i++) {
+        micro_sink += check_collision_rect(d->rects[i & (MICRO_INPUTS - 1)],
+                d->rects[(i + 1) & (MICRO_INPUTS - 1)]);
+    }
+}
+
+static void micro_hitbox(void *data, long n) {
+    MicroData *d = data;
+    SDL_Rect box;
+    long i;
+    for(i = 0; i < n; i++) {
+        box = get_hitbox(d->entities[i & (MICRO_INPUTS - 1)]);
+        micro_sink += box.x + box.w;
+    }
+}
+
+static void micro_bezier(void *data, long n) {
+    MicroData *d = data;
+    Vec2f p;
+    long i;
+    int j;
+    for(i = 0; i < n; i++) {
+        j = i & (MICRO_INPUTS - 1);
+        p = get_vec2f_bezier_opt(d->points[j],
+                d->points[(j + 1) & (MICRO_INPUTS - 1)],
+                d->points[(j + 2) & (MICRO_INPUTS - 1)], d->t[j]);
+        micro_sink += (int)(p.x + p.y);
+    }
+}
+
+static void micro_mt_rand(void *data, long n) {
+    long i;
+    for(i = 0; i < n; i++) {
+        micro_sink += mt_rand(0, 100);
+    }
+}
+
+static void micro_genrand_real1(void *data, long n) {
+    long i;
+    for(i = 0; i < n; i++) {
+        micro_sink += (int)(genrand_real1() * 100);
+    }
+}
+
+static void micro_ht_insert(void *data, long n) {
+    /* Distinct keys into a fresh table, started over every MICRO_HT_KEYS */
+    MicroData *d = data;
+    Vec2i value = {1, 1};
+    long i;
+    for(i = 0; i < n; i++) {
+        if((i % MICRO_HT_KEYS) == 0) {
+            if(d->table) destroy_Vec2iHT(d->table);
+            d->table = create_Vec2iHT(MICRO_HT_KEYS * 2);
+        }
+        insert_Vec2iHT(d->table, d->keys[i % MICRO_HT_KEYS], value);
+    }
+    micro_sink += d->table->count;
+}
+
+static void micro_ht_search(void *data, long n) {
+    MicroData *d = data;
+    Vec2i v;
+    long i;
+    for(i = 0; i < n; i++) {
+        v = search_Vec2iHT(d->table, d->keys[i & (MICRO_INPUTS - 1)]);
+        micro_sink += v.x;
+    }
+}
+
+static void micro_pq(void *data, long n) {
+    /* One push and one pop, on a queue of MICRO_PQ_SIZE */
+    MicroData *d = data;
+    Vec2i v;
+    long i;
+    for(i = 0; i < n; i++) {
+        push_Vec2iPQ(&d->queue, d->keys[i & (MICRO_INPUTS - 1)],
+                d->priorities[i & (MICRO_INPUTS - 1)]);
+        v = pop_Vec2iPQ(&d->queue);
+        micro_sink += v.x;
+    }
+}
+
+static void micro_vtext(void *data, long n) {
+    /* The HUD's score text, through wsl_texture_load_vtext */
+    MicroData *d = data;
+    SDL_Color white = {255, 255, 255, 255};
+    long i;
+    for(i = 0; i < n; i++) {
+        wsl_texture_load_text(d->app, d->tex, white, "Score: %d",
+                (int)(i * 50));
+    }
+}
+
+/*****
+ * Setup
+ *****/
+static void micro_fill(MicroData *d) {
+    SDL_Rect rect = {224, 664, 101, 84};
+    Vec2i tmp;
+    int i, j;
+    for(i = 0; i < MICRO_INPUTS; i++) {
+        d->rects[i] = (SDL_Rect){mt_rand(0, SCREEN_WIDTH),
+            mt_rand(0, SCREEN_HEIGHT), mt_rand(8, 128), mt_rand(8, 128)};
+        d->entities[i] = create_entity(rect);
+        d->entities[i]->x = mt_rand(0, SCREEN_WIDTH);
+        d->entities[i]->y = mt_rand(0, SCREEN_HEIGHT);
+        d->entities[i]->spritescale = 0.25 + mt_real();
+        d->points[i] = (Vec2f){mt_rand(0, SCREEN_WIDTH),
+            mt_rand(0, SCREEN_HEIGHT)};
+        d->t[i] = mt_real();
+        d->priorities[i] = mt_rand(0, 1000);
+    }
+    // Distinct keys, shuffled
+    for(i = 0; i < MICRO_INPUTS; i++) {
+        d->keys[i] = (Vec2i){i % 32, i / 32};
+    }
+    for(i = MICRO_INPUTS - 1; i > 0; i--) {
+        j = mt_rand(0, i);
+        tmp = d->keys[i];
+        d->keys[i] = d->keys[j];
+        d->keys[j] = tmp;
+    }
+}
+
+static void micro_list(MicroData *d, int size) {
+    /* An entity list of size, nothing else in the app */
+    SDL_Rect rect = {224, 664, 101, 84};
+    int i;
+    d->app = calloc(1, sizeof(WSL_App));
+    for(i = 0; i < size; i++) {
+        wsl_add_entity(d->app, create_entity(rect));
+    }
+}
+
+static void micro_list_destroy(MicroData *d) {
+    Entity *e = NULL;
+    while(d->app->entities) {
+        e = d->app->entities;
+        d->app->entities = e->next;
+        destroy_entity(e);
+    }
+    free(d->app);
+    d->app = NULL;
+}
+
+int bench_micro(void) {
+    /*
+     * The engine's small hot functions one at a time, each with warmup,
+     * repetitions and median/p99 (bench_measure). These are what --json is
+     * for, to catch a regression in any one of them.
+     */
+    MicroData *d = calloc(1, sizeof(MicroData));
+    SDL_Rect rect = {224, 664, 101, 84};
+    BenchStats stats;
+    char name[64];
+    int i;
+    Vec2i value = {1, 1};
+
+    if(!d) return 1;
+    mt_seed(20241019);
+    init_genrand(20241019);
+    micro_fill(d);
+
+    stats = bench_measure(&micro_create_destroy, d, 0);
+    bench_result("create_entity + destroy_entity", &stats);
+
+    d->extra = create_entity(rect);
+    for(i = 0; i < (int)(sizeof(list_sizes) / sizeof(list_sizes[0])); i++) {
+        micro_list(d, list_sizes[i]);
+        stats = bench_measure(&micro_add_remove, d, 0);
+        snprintf(name, sizeof(name), "add + remove_entity, %d in list",
+                list_sizes[i]);
+        bench_result(name, &stats);
+        micro_list_destroy(d);
+    }
+    destroy_entity(d->extra);
+
+    stats = bench_measure(&micro_collision, d, 0);
+    bench_result("check_collision_rect", &stats);
+    stats = bench_measure(&micro_hitbox, d, 0);
+    bench_result("get_hitbox", &stats);
+    stats = bench_measure(&micro_bezier, d, 0);
+    bench_result("get_vec2f_bezier_opt", &stats);
+    stats = bench_measure(&micro_mt_rand, d, 0);
+    bench_result("mt_rand", &stats);
+    stats = bench_measure(&micro_genrand_real1, d, 0);
+    bench_result("genrand_real1", &stats);
+
+    stats = bench_measure(&micro_ht_insert, d, 0);
+    bench_result("insert_Vec2iHT", &stats);
+    destroy_Vec2iHT(d->table);
+    d->table = create_Vec2iHT(MICRO_HT_KEYS * 2); // Searched, not changed
+    for(i = 0; i < MICRO_INPUTS; i++) {
+        insert_Vec2iHT(d->table, d->keys[i], value);
+    }
+    stats = bench_measure(&micro_ht_search, d, 0);
+    bench_result("search_Vec2iHT", &stats);
+    destroy_Vec2iHT(d->table);
+
+    for(i = 0; i < MICRO_PQ_SIZE; i++) {
+        push_Vec2iPQ(&d->queue, d->keys[i], d->priorities[i]);
+    }
+    stats = bench_measure(&micro_pq, d, 0);
+    bench_result("push + pop_Vec2iPQ", &stats);
+    destroy_Vec2iPQ(&d->queue);
+
+    d->app = bench_app_create(RB_SDL);
+    if(d->app) {
+        d->tex = create_wsl_texture(d->app->renderer);
+        stats = bench_measure(&micro_vtext, d, 0);
+        bench_result("wsl_texture_load_vtext", &stats);
+        destroy_wsl_texture(d->tex);
+        bench_app_destroy(d->app);
+    }
+
+    for(i = 0; i < MICRO_INPUTS; i++) {
+        destroy_entity(d->entities[i]);
+    }
+    free(d);
+    return 0;
+}
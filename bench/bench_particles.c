@@ -0,0 +1,114 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define PARTICLE_COUNT 200000
+#define PARTICLE_TICKS 40 // Long enough for every particle to start decaying
+
+static void particles_reset(Entity **particles, int count) {
+    /* Lay out the same explosion every run, scattered like
+     * spawn_explosion_particle does it */
+    RNGBlock blk;
+    float s = 0, c = 0;
+    int i;
+    rng_block_seed(&blk, 20241001);
+    for(i = 0; i < count; i++) {
+        Entity *p = particles[i];
+        fast_sincos_bits(rng_block_next(&blk), &s, &c);
+        p->x = (SCREEN_WIDTH / 2) + 20*rng_block_real(&blk)*c;
+        p->y = (SCREEN_HEIGHT / 2) + 20*rng_block_real(&blk)*s;
+        p->dx = 10*rng_block_real(&blk) * (rng_block_bool(&blk) ? -1 : 1);
+        p->dy = 10*rng_block_real(&blk) * (rng_block_bool(&blk) ? -1 : 1);
+        p->speed = 1;
+        p->angle = 45;
+        p->rgba[3] = 200;
+        p->frame = rng_block_range(&blk, 0, 5);
+        p->flags = EF_ALIVE | EF_BURST;
+        p->update = &update_particle;
+    }
+}
+
+static uint64_t particles_checksum(Entity **particles, int count) {
+    /* FNV-1a over the raw state, any difference between runs shows up */
+    uint64_t h = 14695981039346656037ULL;
+    uint32_t v[4];
+    int i, j;
+    for(i = 0; i < count; i++) {
+        memcpy(&v[0], &particles[i]->x, 4);
+        memcpy(&v[1], &particles[i]->y, 4);
+        memcpy(&v[2], &particles[i]->dx, 4);
+        v[3] = (uint32_t)particles[i]->speed ^ ((uint32_t)particles[i]->flags << 8);
+        for(j = 0; j < 4; j++) {
+            h = (h ^ v[j]) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+int bench_particles(void) {
+    /*
+     * Run the same 200k particle explosion with 1, 2, 4... threads up to one
+     * per CPU. Every run has to end in exactly the same state.
+     */
+    static WSL_App game; // Only the pool is used
+    SDL_Rect spriterect = {576,300,24,24};
+    Entity **particles = malloc(sizeof(Entity*) * PARTICLE_COUNT);
+    int i, t, tick, maxthreads = SDL_GetCPUCount();
+    double start, ns, base = 0;
+    uint64_t sum = 0, firstsum = 0;
+    bool same = true;
+    char name[64];
+
+    if(maxthreads > MAX_WORKER_THREADS + 1) maxthreads = MAX_WORKER_THREADS + 1;
+    for(i = 0; i < PARTICLE_COUNT; i++) {
+        particles[i] = create_entity(spriterect);
+    }
+    for(t = 1; t <= maxthreads; t = (t * 2 > maxthreads && t < maxthreads) ?
+            maxthreads : t * 2) {
+        game.pool = wsl_pool_create(t);
+        particles_reset(particles, PARTICLE_COUNT);
+        start = bench_now_ns();
+        for(tick = 0; tick < PARTICLE_TICKS; tick++) {
+            update_particles(&game, particles, PARTICLE_COUNT, 1000 + tick);
+        }
+        ns = bench_now_ns() - start;
+        sum = particles_checksum(particles, PARTICLE_COUNT);
+        if(t == 1) {
+            base = ns;
+            firstsum = sum;
+        }
+        if(sum != firstsum) same = false;
+        snprintf(name, sizeof(name), "update_particles %2d thread(s)",
+                wsl_pool_threads(game.pool));
+        bench_report(name, ns, (long)PARTICLE_COUNT * PARTICLE_TICKS);
+        printf("%-36s %10.2fx speedup, checksum %016llx\n", "", base / ns,
+                (unsigned long long)sum);
+        wsl_pool_destroy(game.pool);
+        game.pool = NULL;
+    }
+
+    for(i = 0; i < PARTICLE_COUNT; i++) {
+        destroy_entity(particles[i]);
+    }
+    free(particles);
+    printf("Results %s across thread counts\n", same ? "identical" : "DIFFER, FAIL");
+    return same ? 0 : 1;
+}
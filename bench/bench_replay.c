@@ -0,0 +1,114 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define REPLAY_PATH "bench_replay.ssrp"
+#define REPLAY_TICKS (10 * 60 * BASE_TICK_RATE) // Ten minutes, or game over
+
+static const int replay_keys[] = {
+    SDL_SCANCODE_UP, SDL_SCANCODE_DOWN, SDL_SCANCODE_LEFT, SDL_SCANCODE_RIGHT,
+    SDL_SCANCODE_SPACE
+};
+
+static void replay_script(WSL_App *app, RNG *script) {
+    /* Someone mashing the arrows and space, from an RNG of its own so the
+     * game's random numbers aren't touched */
+    int i;
+    for(i = 0; i < (int)(sizeof(replay_keys) / sizeof(replay_keys[0])); i++) {
+        if(rng_bounded(script, 100) < 4) {
+            app->keyboard[replay_keys[i]] = !app->keyboard[replay_keys[i]];
+        }
+    }
+}
+
+int bench_replay(void) {
+    /*
+     * Record a game of scripted play, then play the file back in a
+     * fresh app: it has to end up in exactly the same state
+     */
+    WSL_App *app = bench_app_create(RB_CPU);
+    Replay *replay = NULL;
+    RNG script;
+    FILE *file = NULL;
+    uint64_t want, got;
+    long bytes = 0;
+    double start, recordns, playns;
+    uint32_t ticks;
+    int i;
+
+    if(!app) return 1;
+    mt_seed(1); // Shouldn't matter, the replay seeds it
+    rng_seed(&script, 20241019);
+    app->replay = replay_record(REPLAY_PATH, 20241019, app->tickrate);
+    if(!app->replay) {
+        bench_app_destroy(app);
+        return 1;
+    }
+    app->state = GS_NEW;
+    start = bench_now_ns();
+    for(i = 0; (i < REPLAY_TICKS) && !replay_done(app->replay); i++) {
+        replay_script(app, &script);
+        update(app);
+    }
+    recordns = bench_now_ns() - start;
+    replay_close(app->replay, app);
+    app->replay = NULL;
+    bench_app_destroy(app);
+
+    app = bench_app_create(RB_CPU);
+    replay = app ? replay_open(REPLAY_PATH) : NULL;
+    if(!replay) {
+        bench_app_destroy(app);
+        remove(REPLAY_PATH);
+        return 1;
+    }
+    file = fopen(REPLAY_PATH, "rb");
+    if(file) {
+        fseek(file, 0, SEEK_END);
+        bytes = ftell(file);
+        fclose(file);
+    }
+    want = replay->hash;
+    ticks = replay->ticks;
+    mt_seed(2);
+    app->replay = replay;
+    app->state = GS_NEW;
+    start = bench_now_ns();
+    while(!replay_done(app->replay)) {
+        update(app);
+    }
+    playns = bench_now_ns() - start;
+    got = replay_state_hash(app);
+    app->replay = NULL;
+    replay->done = true; // Checked here, no need for replay_close to
+    replay_close(replay, app);
+    bench_app_destroy(app);
+    remove(REPLAY_PATH);
+
+    printf("%-36s %10u ticks %8ld bytes %6.2f bytes/tick\n", "recording",
+            ticks, bytes, ticks ? (double)bytes / ticks : 0);
+    bench_report("record update", recordns, ticks);
+    bench_report("replay update", playns, ticks);
+    printf("State %016llx recorded, %016llx replayed: %s\n",
+            (unsigned long long)want, (unsigned long long)got,
+            want == got ? "same game" : "DIFFERENT, FAIL");
+    return want == got ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define RNG_ITERATIONS 10000000L
+#define RNG_SAMPLES 1000000L
+
+static volatile long sink; // Keeps the compiler from dropping the loops
+
+/*****
+ * The old mt_* helpers, kept here as the baseline
+ *****/
+static int legacy_rand_lim(int limit) {
+    int divisor = RAND_MAX/(limit + 1);
+    int retval;
+    do {
+        retval = genrand_int32() / divisor;
+    } while (retval > limit);
+    return retval;
+}
+
+static int legacy_rand(int min, int max) {
+    return (legacy_rand_lim(max - min) + min);
+}
+
+static bool legacy_bool(void) {
+    return (legacy_rand(1,10) <= 5);
+}
+
+static bool legacy_chance(int chance) {
+    return (legacy_rand(1,100) <= chance);
+}
+
+/*****
+ * Throughput
+ *****/
+static void bench_rng_throughput(void) {
+    long i, acc = 0;
+    double start;
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += genrand_int32();
+    bench_report("genrand_int32", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += rng_next(rng_global());
+    bench_report(rng_name(), bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += legacy_rand(0, 255);
+    bench_report("legacy mt_rand(0,255)", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += mt_rand(0, 255);
+    bench_report("mt_rand(0,255)", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += legacy_bool();
+    bench_report("legacy mt_bool", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += mt_bool();
+    bench_report("mt_bool", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += legacy_chance(33);
+    bench_report("legacy mt_chance(33)", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += mt_chance(33);
+    bench_report("mt_chance(33)", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += (long)(genrand_real1() * 100);
+    bench_report("genrand_real1", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) acc += (long)(mt_real() * 100);
+    bench_report("mt_real", bench_now_ns() - start, RNG_ITERATIONS);
+
+    sink = acc;
+}
+
+/*****
+ * Statistical sanity checks. These aren't a replacement for TestU01 or
+ * PractRand, they just catch a broken bounded/bit path (off by one ranges,
+ * stuck bits, lopsided booleans). Critical values are for p = 0.001.
+ *****/
+static bool check_chi_square(const char *name, long *counts, int bins,
+        long samples, double critical) {
+    int i;
+    double expected = (double)samples / bins;
+    double chi = 0, d = 0;
+    for(i = 0; i < bins; i++) {
+        d = counts[i] - expected;
+        chi += (d * d) / expected;
+    }
+    printf("%-36s chi2 = %8.2f (df %2d, limit %6.2f) %s\n", name, chi,
+            bins - 1, critical, (chi < critical) ? "PASS" : "FAIL");
+    return (chi < critical);
+}
+
+static bool check_proportion(const char *name, long hits, long samples,
+        double p) {
+    double mean = samples * p;
+    double z = (hits - mean) / sqrt(mean * (1 - p));
+    printf("%-36s z    = %8.2f (limit +-3.29)          %s\n", name, z,
+            (fabs(z) < 3.29) ? "PASS" : "FAIL");
+    return (fabs(z) < 3.29);
+}
+
+static bool bench_rng_sanity(void) {
+    long counts[32] = {0};
+    long i, hits = 0;
+    int r = 0, bit = 0;
+    uint32_t u = 0;
+    bool pass = true, inrange = true;
+
+    mt_seed(20240929);
+
+    // mt_rand(0,9): uniform over 10 bins
+    for(i = 0; i < RNG_SAMPLES; i++) {
+        r = mt_rand(0,9);
+        if(r < 0 || r > 9) { inrange = false; break; }
+        counts[r] += 1;
+    }
+    pass &= inrange && check_chi_square("mt_rand(0,9)", counts, 10,
+            RNG_SAMPLES, 27.88);
+
+    // mt_rand(1,6): dice, offset range
+    memset(counts, 0, sizeof(counts));
+    for(i = 0; i < RNG_SAMPLES; i++) {
+        r = mt_rand(1,6);
+        if(r < 1 || r > 6) { inrange = false; break; }
+        counts[r - 1] += 1;
+    }
+    pass &= inrange && check_chi_square("mt_rand(1,6)", counts, 6,
+            RNG_SAMPLES, 20.52);
+
+    // mt_rand(-4,-2): negative ranges (used by the thruster particles)
+    memset(counts, 0, sizeof(counts));
+    for(i = 0; i < RNG_SAMPLES; i++) {
+        r = mt_rand(-4,-2);
+        if(r < -4 || r > -2) { inrange = false; break; }
+        counts[r + 4] += 1;
+    }
+    pass &= inrange && check_chi_square("mt_rand(-4,-2)", counts, 3,
+            RNG_SAMPLES, 13.82);
+    if(!inrange) printf("mt_rand returned a value out of range! FAIL\n");
+
+    // mt_bool: fair coin
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_bool();
+    pass &= check_proportion("mt_bool", hits, RNG_SAMPLES, 0.5);
+
+    // mt_chance: 15%, 33% and 75% are the chances the game uses
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_chance(15);
+    pass &= check_proportion("mt_chance(15)", hits, RNG_SAMPLES, 0.15);
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_chance(33);
+    pass &= check_proportion("mt_chance(33)", hits, RNG_SAMPLES, 0.33);
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_chance(75);
+    pass &= check_proportion("mt_chance(75)", hits, RNG_SAMPLES, 0.75);
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_chance(0);
+    if(hits) printf("mt_chance(0) returned true! FAIL\n");
+    pass &= (hits == 0);
+    for(i = 0, hits = 0; i < RNG_SAMPLES; i++) hits += mt_chance(100);
+    if(hits != RNG_SAMPLES) printf("mt_chance(100) returned false! FAIL\n");
+    pass &= (hits == RNG_SAMPLES);
+
+    // Every bit of the raw generator should be set about half the time
+    memset(counts, 0, sizeof(counts));
+    for(i = 0; i < RNG_SAMPLES; i++) {
+        u = rng_next(rng_global());
+        for(bit = 0; bit < 32; bit++) {
+            counts[bit] += (u >> bit) & 1;
+        }
+    }
+    for(bit = 0; bit < 32; bit++) {
+        if(fabs((counts[bit] - RNG_SAMPLES * 0.5) /
+                    sqrt(RNG_SAMPLES * 0.25)) >= 3.89) {
+            printf("%s bit %d is biased: %ld/%ld FAIL\n", rng_name(), bit,
+                    counts[bit], RNG_SAMPLES);
+            pass = false;
+        }
+    }
+    printf("%-36s %s\n", "raw bit balance", pass ? "PASS" : "FAIL");
+    return pass;
+}
+
+/*****
+ * Block generator
+ *****/
+static void bench_report_per_ns(const char *name, double ns, long values) {
+    printf("%-36s %10.3f values/ns\n", name, values / ns);
+}
+
+int bench_rng_block(void) {
+    /* Sums go into four accumulators so the loops measure the generators, not
+     * the latency of one long chain of float adds */
+    RNGBlock *blk = rng_block_global();
+    long i, bins[16] = {0};
+    double start, a[4] = {0};
+    uint32_t uacc = 0;
+    float f = 0;
+    bool inrange = true;
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i += 4) {
+        a[0] += genrand_real1(); a[1] += genrand_real1();
+        a[2] += genrand_real1(); a[3] += genrand_real1();
+    }
+    bench_report_per_ns("genrand_real1", bench_now_ns() - start,
+            RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i += 4) {
+        a[0] += mt_real(); a[1] += mt_real();
+        a[2] += mt_real(); a[3] += mt_real();
+    }
+    bench_report_per_ns("mt_real", bench_now_ns() - start, RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i += 4) {
+        a[0] += rng_block_real(blk); a[1] += rng_block_real(blk);
+        a[2] += rng_block_real(blk); a[3] += rng_block_real(blk);
+    }
+    bench_report_per_ns("rng_block_real", bench_now_ns() - start,
+            RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i += 4) {
+        a[0] += mt_fast_real(); a[1] += mt_fast_real();
+        a[2] += mt_fast_real(); a[3] += mt_fast_real();
+    }
+    bench_report_per_ns("mt_fast_real", bench_now_ns() - start,
+            RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) uacc += rng_block_next(blk);
+    bench_report_per_ns("rng_block_next", bench_now_ns() - start,
+            RNG_ITERATIONS);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS / RNG_BLOCK_SIZE; i++) {
+        rng_block_fill_real(blk);
+        a[0] += blk->real[i % RNG_BLOCK_SIZE];
+    }
+    bench_report_per_ns("rng_block_fill_real (refill only)", 
+            bench_now_ns() - start, 
+            (RNG_ITERATIONS / RNG_BLOCK_SIZE) * RNG_BLOCK_SIZE);
+
+    start = bench_now_ns();
+    for(i = 0; i < RNG_ITERATIONS; i++) uacc += mt_fast_rand(0, 255);
+    bench_report_per_ns("mt_fast_rand(0,255)", bench_now_ns() - start,
+            RNG_ITERATIONS);
+    sink = (long)(a[0] + a[1] + a[2] + a[3]) + uacc;
+
+    // Floats should be on [0,1) and spread evenly
+    rng_block_seed(blk, 20240929);
+    for(i = 0; i < RNG_SAMPLES; i++) {
+        f = rng_block_real(blk);
+        if(f < 0 || f >= 1) { inrange = false; break; }
+        bins[(int)(f * 16)] += 1;
+    }
+    if(!inrange) printf("rng_block_real out of [0,1)! FAIL\n");
+    return (inrange && check_chi_square("rng_block_real 16 bins", bins, 16,
+                RNG_SAMPLES, 37.70)) ? 0 : 1;
+}
+
+int bench_rng(void) {
+    printf("Generator: %s\n", rng_name());
+    bench_rng_throughput();
+    return bench_rng_sanity() ? 0 : 1;
+}
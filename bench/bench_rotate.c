@@ -0,0 +1,98 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+static void rotate_scene(WSL_App *app) {
+    /* Everything that spins: asteroids and UFOs turned every which way, and
+     * explosions full of 45 degree particles */
+    SDL_Rect uforect = {505,898,91,91};
+    Entity *entity = NULL;
+    int i;
+    for(i = 0; i < 40; i++) {
+        entity = create_asteroid();
+        entity->x = mt_rand(0, SCREEN_WIDTH);
+        entity->y = mt_rand(0, SCREEN_HEIGHT);
+        entity->angle = mt_rand(0, 71) * 5;
+        wsl_add_entity(app, entity);
+    }
+    for(i = 0; i < 10; i++) {
+        entity = create_ufo(uforect);
+        entity->x = mt_rand(0, SCREEN_WIDTH);
+        entity->y = mt_rand(0, SCREEN_HEIGHT / 2);
+        entity->angle = mt_rand(0, 23) * 15;
+        wsl_add_entity(app, entity);
+    }
+    for(i = 0; i < 40; i++) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                app);
+    }
+}
+
+static void rotate_frames(void *data, long n) {
+    long i;
+    for(i = 0; i < n; i++) {
+        draw_game(data);
+    }
+}
+
+static double rotate_frame_us(WSL_App *app, const char *name) {
+    /* Median frame time over the repetitions, printed */
+    BenchStats stats = bench_measure(&rotate_frames, app, 1);
+    printf("%-36s %10.1f us/frame median %10.1f p99\n", name,
+            stats.median / 1000, stats.p99 / 1000);
+    return stats.median;
+}
+
+int bench_rotate(void) {
+    /*
+     * Frame time of draw_game() on the software renderer with the turned
+     * sprites drawn through SDL, and then with them coming out of the
+     * rotation cache, which has to be faster. The cache is only used on
+     * SDL's software renderer, so link against a real SDL for frame times
+     * that mean anything.
+     */
+    WSL_App *app = bench_app_create(RB_SDL);
+    WSL_RotCache *cache = NULL;
+    double turned, cached;
+    if(!app) return 1;
+    if(!app->rotcache) {
+        printf("No rotation cache (not a software renderer?)\n");
+        bench_app_destroy(app);
+        return 1;
+    }
+    mt_seed(20241003);
+    rotate_scene(app);
+    app->state = GS_GAME;
+    bench_renderer_info(app);
+    printf("%-36s %10d entities\n", "scene", count_entities(app->entities));
+
+    cache = app->rotcache;
+    app->rotcache = NULL;
+    turned = rotate_frame_us(app, "draw_game, turned quads");
+    app->rotcache = cache;
+    cached = rotate_frame_us(app, "draw_game, rotation cache");
+    printf("%-36s %10.2fx\n", "speedup", turned / cached);
+    printf("%-36s %10dx%d\n", "cache texture", cache->tex->w, cache->tex->h);
+    printf("Rotation cache %s\n", cached < turned ? "is faster" :
+            "ISN'T FASTER, FAIL");
+    bench_app_destroy(app);
+    return cached < turned ? 0 : 1;
+}
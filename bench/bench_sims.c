@@ -0,0 +1,107 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define SIMS_COUNT 64 // Games run side by side
+#define SIMS_TICKS (20 * BASE_TICK_RATE) // Twenty seconds of each
+#define SIMS_SEED 20241019
+
+static WSL_App** sims_create(void) {
+    WSL_App **sims = calloc(SIMS_COUNT, sizeof(WSL_App*));
+    int i;
+    if(!sims) return NULL;
+    for(i = 0; i < SIMS_COUNT; i++) {
+        sims[i] = sim_create(SIMS_SEED + i);
+        if(sims[i]) sims[i]->autopilot = autopilot_create();
+    }
+    return sims;
+}
+
+static void sims_destroy(WSL_App **sims) {
+    int i;
+    for(i = 0; i < SIMS_COUNT; i++) {
+        sim_destroy(sims[i]);
+    }
+    free(sims);
+}
+
+int bench_sims(void) {
+    /*
+     * SIMS_COUNT autopiloted games run on 1, 2, 4... threads, up to one per
+     * CPU (and at least 4, so the sharing gets tested on small machines too).
+     * Every game has to come out the same whatever thread ran it and
+     * whatever else ran alongside it, and the first has to match the same
+     * seed played alone on the process wide RNG.
+     */
+    WSL_App **sims = NULL;
+    WSL_App *alone = NULL;
+    WSL_Pool *pool = NULL;
+    uint64_t want[SIMS_COUNT], elapsed;
+    double rate, base = 0;
+    int t, i, maxthreads = SDL_GetCPUCount();
+    bool same = true;
+    char name[64];
+    long tick;
+
+    if(maxthreads < 4) maxthreads = 4;
+    if(maxthreads > MAX_WORKER_THREADS + 1) maxthreads = MAX_WORKER_THREADS + 1;
+    printf("%-36s %10d games, %d ticks each, %d CPU(s)\n", "sims",
+            SIMS_COUNT, SIMS_TICKS, SDL_GetCPUCount());
+
+    for(t = 1; t <= maxthreads; t = (t * 2 > maxthreads && t < maxthreads) ?
+            maxthreads : t * 2) {
+        sims = sims_create();
+        if(!sims) return 1;
+        pool = wsl_pool_create(t);
+        elapsed = sim_run(pool, sims, SIMS_COUNT, SIMS_TICKS);
+        rate = (double)SIMS_COUNT * SIMS_TICKS / elapsed * NS_PER_SEC;
+        if(t == 1) base = rate;
+        for(i = 0; i < SIMS_COUNT; i++) {
+            if(!sims[i]) {
+                same = false;
+                continue;
+            }
+            if(t == 1) want[i] = replay_state_hash(sims[i]);
+            if(replay_state_hash(sims[i]) != want[i]) same = false;
+        }
+        snprintf(name, sizeof(name), "%2d thread(s)", wsl_pool_threads(pool));
+        printf("%-36s %10.0f ticks/s %8.2fx\n", name, rate, rate / base);
+        wsl_pool_destroy(pool);
+        sims_destroy(sims);
+    }
+
+    // The first seed again, played alone on the process wide RNG
+    alone = sim_create(SIMS_SEED);
+    if(!alone) return 1;
+    free(alone->rng);
+    alone->rng = NULL;
+    mt_seed(SIMS_SEED);
+    alone->autopilot = autopilot_create();
+    for(tick = 0; tick < SIMS_TICKS; tick++) {
+        update(alone);
+    }
+    if(replay_state_hash(alone) != want[0]) same = false;
+    sim_destroy(alone);
+
+    printf("Games %s across thread counts\n", same ? "identical" :
+            "DIFFER, FAIL");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define SNAPSHOT_SEED 20241019
+#define SNAPSHOT_PLAY (20 * BASE_TICK_RATE) // Autopiloted play to get a scene
+#define SNAPSHOT_AFTER (30 * BASE_TICK_RATE) // Played on after the snapshot
+#define SNAPSHOT_EXPLOSIONS 20 // Added for a heavy scene
+#define SNAPSHOT_BUDGET_NS 100000.0 // Median save or restore, at most
+
+typedef struct {
+    WSL_App *game;
+    Snapshot snap;
+} SnapshotData;
+
+static void snapshot_bench_save(void *data, long n) {
+    SnapshotData *d = data;
+    long i;
+    for(i = 0; i < n; i++) {
+        snapshot_save(d->game, &d->snap);
+    }
+}
+
+static void snapshot_bench_restore(void *data, long n) {
+    SnapshotData *d = data;
+    long i;
+    for(i = 0; i < n; i++) {
+        snapshot_restore(d->game, &d->snap);
+    }
+}
+
+static uint64_t snapshot_play_on(WSL_App *game) {
+    long i;
+    for(i = 0; i < SNAPSHOT_AFTER; i++) {
+        update(game);
+    }
+    return replay_state_hash(game);
+}
+
+int bench_snapshot(void) {
+    /*
+     * A scene from a game the autopilot's been playing, saved and restored
+     * over and over (each has to stay under SNAPSHOT_BUDGET_NS), and again
+     * with explosions all over the screen for how it scales. Then played
+     * on from the snapshot three ways, in the same game, restored into the
+     * same game, and restored into a brand new one: all three have to end up
+     * the same, and a restored game has to snapshot to the same bytes.
+     */
+    SnapshotData d = {0};
+    Snapshot again = {0};
+    BenchStats save, restore, heavy;
+    WSL_App *fresh = NULL;
+    uint64_t want, got, gotfresh;
+    bool same = true, within;
+    long i;
+
+    d.game = sim_create(SNAPSHOT_SEED);
+    if(!d.game) return 1;
+    d.game->autopilot = autopilot_create();
+    for(i = 0; i < SNAPSHOT_PLAY; i++) {
+        update(d.game);
+    }
+    // From here on it plays itself, keys held as they were
+    autopilot_destroy(d.game->autopilot);
+    d.game->autopilot = NULL;
+
+    if(!snapshot_save(d.game, &d.snap)) {
+        sim_destroy(d.game);
+        return 1;
+    }
+    printf("%-36s %10d entities %8zu bytes\n", "scene",
+            count_entities(d.game->entities), d.snap.size);
+    save = bench_measure(&snapshot_bench_save, &d, 0);
+    bench_result("snapshot_save", &save);
+    restore = bench_measure(&snapshot_bench_restore, &d, 0);
+    bench_result("snapshot_restore", &restore);
+
+    // The same with a screen full of explosions, for scale
+    for(i = 0; i < SNAPSHOT_EXPLOSIONS; i++) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                d.game);
+    }
+    snapshot_save(d.game, &d.snap);
+    printf("%-36s %10d entities %8zu bytes\n", "with explosions",
+            count_entities(d.game->entities), d.snap.size);
+    heavy = bench_measure(&snapshot_bench_save, &d, 0);
+    bench_result("snapshot_save, explosions", &heavy);
+    heavy = bench_measure(&snapshot_bench_restore, &d, 0);
+    bench_result("snapshot_restore, explosions", &heavy);
+    snapshot_save(d.game, &d.snap);
+
+    // Same game, played on, then put back and played on again
+    snapshot_restore(d.game, &d.snap);
+    want = snapshot_play_on(d.game);
+    if(!snapshot_restore(d.game, &d.snap)) same = false;
+    snapshot_save(d.game, &again);
+    if((again.size != d.snap.size) ||
+            (memcmp(again.data, d.snap.data, d.snap.size) != 0)) {
+        same = false;
+    }
+    got = snapshot_play_on(d.game);
+
+    // And a new game restored from it
+    fresh = sim_create(1);
+    if(!fresh || !snapshot_restore(fresh, &d.snap)) same = false;
+    gotfresh = fresh ? snapshot_play_on(fresh) : 0;
+    if((got != want) || (gotfresh != want)) same = false;
+
+    printf("State %016llx played on, %016llx restored, %016llx new game: %s\n",
+            (unsigned long long)want, (unsigned long long)got,
+            (unsigned long long)gotfresh, same ? "same game" :
+            "DIFFERENT, FAIL");
+    within = (save.median <= SNAPSHOT_BUDGET_NS) &&
+        (restore.median <= SNAPSHOT_BUDGET_NS);
+    printf("Snapshots %s\n", within ? "within budget" : "OVER BUDGET, FAIL");
+
+    sim_destroy(fresh);
+    sim_destroy(d.game);
+    snapshot_free(&d.snap);
+    snapshot_free(&again);
+    return (same && within) ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define STRESS_WARMUP 60 // Ticks to settle at a new density before timing
+#define STRESS_TICKS 120 // Ticks timed at each density
+#define STRESS_LEVELS 7
+
+/*
+ * A scene held at a density of n: called before every tick to top it back
+ * up (or keep it going at that rate), through the game's own spawn
+ * functions.
+ */
+typedef struct {
+    const char *name;
+    const char *unit;
+    void (*fill)(WSL_App *app, int n, int tick);
+    int levels[STRESS_LEVELS];
+} StressScene;
+
+static int stress_count(WSL_App *app, void (*update)(Entity*, WSL_App*),
+        int flags) {
+    Entity *e = NULL;
+    int count = 0;
+    for(e = app->entities; e; e = e->next) {
+        if((e->update == update) && ((e->flags & flags) == flags)) count++;
+    }
+    return count;
+}
+
+static void stress_asteroids(WSL_App *app, int n, int tick) {
+    /* n asteroids on screen, new ones coming in as the old ones leave */
+    int i = stress_count(app, &update_asteroid, EF_ALIVE);
+    for(; i < n; i++) {
+        spawn_asteroid(app);
+    }
+}
+
+static void stress_ufos(WSL_App *app, int n, int tick) {
+    /* n UFOs flying their curves, and shooting */
+    int i = stress_count(app, &ufo_update, EF_ALIVE);
+    for(; i < n; i++) {
+        spawn_ufo(app, NULL);
+    }
+}
+
+static void stress_explosions(WSL_App *app, int n, int tick) {
+    /* n explosions a second, all over the screen */
+    int due = (int)(((long)(tick + 1) * n) / app->tickrate) -
+        (int)(((long)tick * n) / app->tickrate);
+    for(; due > 0; due--) {
+        spawn_explosion(mt_rand(0, SCREEN_WIDTH), mt_rand(0, SCREEN_HEIGHT),
+                app);
+    }
+}
+
+static void stress_projectiles(WSL_App *app, int n, int tick) {
+    /* n enemy shots in flight, fired from random spots along the top */
+    SDL_Rect projrect = {843, 903, 13, 37};
+    SDL_Rect fromrect = {505, 898, 91, 91};
+    Entity from = {0};
+    Entity *proj = NULL;
+    int i = stress_count(app, &update_projectile, EF_ALIVE | EF_ENEMY);
+    from.spriterect = fromrect;
+    from.spritescale = 0.75;
+    for(; i < n; i++) {
+        from.x = mt_rand(0, SCREEN_WIDTH - 68);
+        from.y = mt_rand(1, SCREEN_HEIGHT / 2);
+        proj = create_projectile(&from, projrect);
+        proj->flags |= EF_ENEMY;
+        proj->dy = 1;
+        proj->angle = 180;
+        proj->spritescale = from.spritescale;
+        wsl_add_entity(app, proj);
+    }
+}
+
+static const StressScene scenes[] = {
+    {"asteroids", "on screen", &stress_asteroids,
+        {0, 25, 50, 100, 200, 400, 800}},
+    {"ufos", "on screen", &stress_ufos, {0, 5, 10, 20, 40, 80, 160}},
+    {"explosions", "per second", &stress_explosions,
+        {0, 15, 30, 60, 120, 240, 480}},
+    {"projectiles", "in flight", &stress_projectiles,
+        {0, 50, 100, 200, 400, 800, 1600}},
+};
+
+static void stress_clear(WSL_App *app) {
+    Entity *e = NULL;
+    while(app->entities) {
+        e = app->entities;
+        app->entities = e->next;
+        destroy_entity(e);
+    }
+    app->numparticles = 0;
+}
+
+static int stress_compare(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int bench_stress(void) {
+    /*
+     * Each scene swept from nothing to heavy, STRESS_TICKS of update() and
+     * draw_game() timed at each density. One CSV row per density, and the
+     * knee: the first density where the slowest ticks (p99) no longer fit
+     * in a 60 Hz frame.
+     */
+    WSL_App *app = bench_app_create(RB_SDL);
+    double budget = (double)NS_PER_SEC / BASE_TICK_RATE;
+    double ticks[STRESS_TICKS];
+    double start, mid, updatens, drawns, p99;
+    long alive;
+    int s, l, tick, knee;
+    const StressScene *scene = NULL;
+    if(!app) return 1;
+    app->state = GS_GAME;
+
+    bench_csv("scene,n,unit,entities,update_us,draw_us,tick_us,p99_us,"
+            "holds_60hz\n");
+    for(s = 0; s < (int)(sizeof(scenes) / sizeof(scenes[0])); s++) {
+        scene = &scenes[s];
+        knee = -1;
+        for(l = 0; l < STRESS_LEVELS; l++) {
+            stress_clear(app);
+            mt_seed(20241019 + l);
+            for(tick = 0; tick < STRESS_WARMUP; tick++) {
+                scene->fill(app, scene->levels[l], tick);
+                app->asteroidspawn = INT32_MAX; // Only the scene spawns things
+                update(app);
+            }
+            updatens = drawns = 0;
+            alive = 0;
+            for(tick = 0; tick < STRESS_TICKS; tick++) {
+                scene->fill(app, scene->levels[l], STRESS_WARMUP + tick);
+                app->asteroidspawn = INT32_MAX;
+                start = bench_now_ns();
+                update(app);
+                mid = bench_now_ns();
+                draw_game(app);
+                ticks[tick] = bench_now_ns() - start;
+                updatens += mid - start;
+                drawns += ticks[tick] - (mid - start);
+                alive += count_entities(app->entities);
+            }
+            qsort(ticks, STRESS_TICKS, sizeof(double), &stress_compare);
+            p99 = ticks[(int)ceil(0.99 * STRESS_TICKS) - 1];
+            if((knee < 0) && (p99 > budget)) knee = scene->levels[l];
+            bench_csv("%s,%d,%s,%.1f,%.1f,%.1f,%.1f,%.1f,%d\n", scene->name,
+                    scene->levels[l], scene->unit,
+                    (double)alive / STRESS_TICKS,
+                    updatens / STRESS_TICKS / 1000,
+                    drawns / STRESS_TICKS / 1000,
+                    (updatens + drawns) / STRESS_TICKS / 1000, p99 / 1000,
+                    p99 <= budget);
+        }
+        if(knee < 0) {
+            printf("# %s: holds 60 Hz all the way to %d %s\n", scene->name,
+                    scene->levels[STRESS_LEVELS - 1], scene->unit);
+        } else {
+            printf("# %s: knee at %d %s\n", scene->name, knee, scene->unit);
+        }
+    }
+    stress_clear(app);
+    bench_app_destroy(app);
+    return 0;
+}
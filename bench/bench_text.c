@@ -0,0 +1,119 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define TEXT_FRAMES 500
+
+static double time_draw_scores(WSL_App *app) {
+    /* Average ns per draw_scores() frame */
+    double start;
+    int i;
+    draw_scores(app); // Warm up
+    start = bench_now_ns();
+    for(i = 0; i < TEXT_FRAMES; i++) {
+        draw_scores(app);
+    }
+    return (bench_now_ns() - start) / TEXT_FRAMES;
+}
+
+static bool check_text_cache(WSL_App *app) {
+    /* Push a small cache over budget and make sure it evicts least recently
+     * used strings first and stays within budget. Every get is its own frame,
+     * strings used in the current frame are never evicted. */
+    SDL_Color white = {255,255,255,255};
+    WSL_TextCache *cache = NULL;
+    WSL_Texture *t = NULL;
+    char str[32];
+    unsigned long misses = 0;
+    size_t each = 0;
+    int i;
+    bool pass = true;
+
+    t = wsl_text_cache_get(app, app->textcache, white, "Score: 0");
+    if(!t) return false;
+    each = (size_t)t->w * t->h * 4; // Bytes per 8 character string
+    cache = wsl_text_cache_create(each * 4);
+    for(i = 0; i < 4; i++) {
+        snprintf(str, sizeof(str), "Score: %d", i);
+        wsl_text_cache_get(app, cache, white, str);
+        wsl_text_cache_next_frame(cache);
+    }
+    wsl_text_cache_get(app, cache, white, "Score: 0"); // Now most recent
+    wsl_text_cache_next_frame(cache);
+    wsl_text_cache_get(app, cache, white, "Score: 4"); // Evicts "Score: 1"
+    wsl_text_cache_next_frame(cache);
+    misses = cache->misses;
+    wsl_text_cache_get(app, cache, white, "Score: 0");
+    wsl_text_cache_next_frame(cache);
+    if(cache->misses != misses) pass = false;
+    wsl_text_cache_get(app, cache, white, "Score: 1");
+    wsl_text_cache_next_frame(cache);
+    if(cache->misses != misses + 1) pass = false;
+    if(cache->bytes > cache->budget) pass = false;
+    printf("text cache LRU: %d entries, %zu/%zu bytes, %lu hits, %lu misses, "
+            "%lu evictions %s\n", cache->count, cache->bytes, cache->budget,
+            cache->hits, cache->misses, cache->evictions, pass ? "OK" : "FAIL");
+    wsl_text_cache_destroy(cache);
+    return pass;
+}
+
+int bench_text(void) {
+    /*
+     * The high score screen is almost all text: a title plus two strings per
+     * score. Time it rendering through hud_text (the old way, a new texture
+     * per string per frame), through the text cache, and through the glyph
+     * atlas.
+     */
+    WSL_App *app = bench_app_create(RB_SDL);
+    WSL_GlyphAtlas *atlas = NULL;
+    WSL_TextCache *cache = NULL;
+    double legacy, cached, after;
+    bool pass = true;
+    if(!app) return 1;
+    if(!app->glyphs || !app->textcache) {
+        printf("No glyph atlas or text cache! FAIL\n");
+        bench_app_destroy(app);
+        return 1;
+    }
+
+    atlas = app->glyphs;
+    cache = app->textcache;
+    app->glyphs = NULL;
+    app->textcache = NULL;
+    legacy = time_draw_scores(app);
+    app->textcache = cache;
+    cached = time_draw_scores(app);
+    app->glyphs = atlas;
+    after = time_draw_scores(app);
+
+    printf("%-36s %10.1f us/frame\n", "draw_scores (hud_text texture)",
+            legacy / 1000);
+    printf("%-36s %10.1f us/frame\n", "draw_scores (text cache)",
+            cached / 1000);
+    printf("%-36s %10.1f us/frame\n", "draw_scores (glyph atlas)",
+            after / 1000);
+    printf("%-36s %10.2fx\n", "speedup (atlas)", legacy / after);
+    printf("text cache: %lu hits, %lu misses, %d entries, %zu bytes\n",
+            cache->hits, cache->misses, cache->count, cache->bytes);
+    pass = check_text_cache(app);
+    bench_app_destroy(app);
+    return pass ? 0 : 1;
+}
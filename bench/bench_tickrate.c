@@ -0,0 +1,174 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define TICKRATE_SECONDS 4 // Game time each run plays out
+
+static const int tickrates[] = {30, 60, 120, 240};
+
+/* When things happened in a run, in seconds of game time */
+typedef struct {
+    double invuln; // Player stops being invulnerable
+    double asteroid; // Asteroid falls off the bottom of the screen
+    double particle; // Particle dies
+    double blip; // "Good luck" text is gone
+    float scroll; // How far the bottom background layer scrolled
+    int shots; // Shots fired, holding down space the whole time
+} TickrateTimes;
+
+static bool tickrate_any(WSL_App *app, void (*update)(Entity*, WSL_App*)) {
+    Entity *e = NULL;
+    for(e = app->entities; e; e = e->next) {
+        if(e->update == update) return true;
+    }
+    return false;
+}
+
+static Entity* tickrate_player(WSL_App *app) {
+    Entity *e = NULL;
+    for(e = app->entities; e; e = e->next) {
+        if(entity_is_player(e) && !entity_is_projectile(e)) return e;
+    }
+    return NULL;
+}
+
+static int tickrate_new_shots(WSL_App *app) {
+    /* Player shots not seen yet, marked off with their (unused) frame */
+    Entity *e = NULL;
+    int shots = 0;
+    for(e = app->entities; e; e = e->next) {
+        if(entity_is_player(e) && entity_is_projectile(e) && !e->frame) {
+            e->frame = 1;
+            shots += 1;
+        }
+    }
+    return shots;
+}
+
+static void tickrate_run(WSL_App *app, int rate, TickrateTimes *t) {
+    /*
+     * A new game with space held down and no asteroids spawning on their
+     * own, plus one asteroid off to the side and one particle to time
+     */
+    SDL_Rect particlerect = {576, 300, 24, 24};
+    Entity *e = NULL, *player = NULL;
+    double now;
+    int tick;
+
+    memset(t, 0, sizeof(TickrateTimes));
+    mt_seed(20241019);
+    set_tick_rate(app, rate);
+    app->bg[0].offset = 0;
+    app->keyboard[SDL_SCANCODE_SPACE] = true;
+    app->state = GS_NEW;
+    update(app); // Tick 0, the game starts
+    app->asteroidspawn = rate * TICKRATE_SECONDS * 2;
+
+    e = create_asteroid();
+    e->x = 50;
+    e->y = 0;
+    e->dx = 0;
+    e->dy = 1;
+    e->speed = 6;
+    wsl_add_entity(app, e);
+
+    e = create_entity(particlerect);
+    e->flags = EF_ALIVE;
+    e->x = 200;
+    e->y = 300;
+    e->update = &update_particle;
+    e->render = &entity_render;
+    wsl_add_entity(app, e);
+
+    for(tick = 1; tick <= rate * TICKRATE_SECONDS; tick++) {
+        update(app);
+        now = (double)tick / rate;
+        player = tickrate_player(app);
+        if(!t->invuln && player && !(player->flags & EF_INV)) t->invuln = now;
+        if(!t->asteroid && !tickrate_any(app, &update_asteroid)) {
+            t->asteroid = now;
+        }
+        if(!t->particle && !tickrate_any(app, &update_particle)) {
+            t->particle = now;
+        }
+        if(!t->blip && !tickrate_any(app, &update_bliptxt)) t->blip = now;
+        t->shots += tickrate_new_shots(app);
+    }
+    t->scroll = app->bg[0].offset;
+    app->keyboard[SDL_SCANCODE_SPACE] = false;
+}
+
+static bool tickrate_close(const char *what, int rate, double got, double want) {
+    // Timers round to the nearest tick, at this rate and at BASE_TICK_RATE
+    double slop = (0.5 / rate) + (0.5 / BASE_TICK_RATE) + 1e-6;
+    if(fabs(got - want) <= slop) return true;
+    printf("%d Hz: %s at %.3f s, %.3f s at %d Hz, FAIL\n", rate, what, got,
+            want, BASE_TICK_RATE);
+    return false;
+}
+
+int bench_tickrate(void) {
+    /*
+     * The same scripted game played at different tick rates has to come out
+     * the same in game time: timers end, things move and scroll as far,
+     * shots come as often. Only rounding to whole ticks is allowed for.
+     */
+    WSL_App *app = bench_app_create(RB_CPU);
+    TickrateTimes base, t;
+    bool same = true;
+    char name[64];
+    int i;
+    double start, ms;
+
+    if(!app) return 1;
+    tickrate_run(app, BASE_TICK_RATE, &base);
+    printf("%-12s %8s %8s %8s %8s %8s %6s %8s\n", "", "invuln", "asteroid",
+            "particle", "blip", "scroll", "shots", "ms");
+    for(i = 0; i < (int)(sizeof(tickrates) / sizeof(tickrates[0])); i++) {
+        start = bench_now_ns();
+        tickrate_run(app, tickrates[i], &t);
+        ms = (bench_now_ns() - start) / 1e6;
+        snprintf(name, sizeof(name), "%d Hz", tickrates[i]);
+        printf("%-12s %7.3fs %7.3fs %7.3fs %7.3fs %6.0fpx %6d %8.2f\n", name,
+                t.invuln, t.asteroid, t.particle, t.blip, t.scroll, t.shots,
+                ms);
+        same &= tickrate_close("invulnerability ends", tickrates[i],
+                t.invuln, base.invuln);
+        same &= tickrate_close("asteroid gone", tickrates[i], t.asteroid,
+                base.asteroid);
+        same &= tickrate_close("particle gone", tickrates[i], t.particle,
+                base.particle);
+        same &= tickrate_close("blip gone", tickrates[i], t.blip, base.blip);
+        if(fabsf(t.scroll - base.scroll) > 1.0f) {
+            printf("%d Hz: scrolled %.1f px, %.1f px at %d Hz, FAIL\n",
+                    tickrates[i], t.scroll, base.scroll, BASE_TICK_RATE);
+            same = false;
+        }
+        if(t.shots != base.shots) {
+            printf("%d Hz: %d shots, %d at %d Hz, FAIL\n", tickrates[i],
+                    t.shots, base.shots, BASE_TICK_RATE);
+            same = false;
+        }
+    }
+    bench_app_destroy(app);
+    printf("Game time %s across tick rates\n", same ? "matches" : "DIFFERS");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define TILES_SPRITES 20000
+#define TILES_MAX_THREADS 8 // Tiled on 1, 2, 4... up to this many threads
+#define TILES_MIN_SPEEDUP 4.0 // Over in place on TILES_MAX_THREADS, when
+                              // there are that many CPUs to run them
+
+typedef struct {
+    SDL_Rect src;
+    SDL_Rect dst;
+    double angle;
+    SDL_BlendMode blend;
+    SDL_Color color;
+} TilesSprite;
+
+static void tiles_scene(TilesSprite *sprites, int count) {
+    /* Mostly small blended particles, some added, and a few big turning
+     * asteroids over the top of them */
+    SDL_Rect particle = {576, 300, 24, 24};
+    SDL_Rect asteroid = {224, 664, 101, 84};
+    SDL_Color white = {255, 255, 255, 255};
+    int i, size;
+    for(i = 0; i < count; i++) {
+        if(i % 50 == 0) {
+            sprites[i].src = asteroid;
+            sprites[i].dst = (SDL_Rect){mt_rand(-50, SCREEN_WIDTH),
+                mt_rand(-50, SCREEN_HEIGHT), asteroid.w, asteroid.h};
+            sprites[i].angle = mt_rand(0, 359);
+            sprites[i].blend = SDL_BLENDMODE_BLEND;
+            sprites[i].color = white;
+        } else {
+            size = mt_rand(8, 32);
+            sprites[i].src = particle;
+            sprites[i].dst = (SDL_Rect){mt_rand(-16, SCREEN_WIDTH),
+                mt_rand(-16, SCREEN_HEIGHT), size, size};
+            sprites[i].angle = 0;
+            sprites[i].blend = (i % 3) ? SDL_BLENDMODE_BLEND :
+                SDL_BLENDMODE_ADD;
+            sprites[i].color = (SDL_Color){255, mt_rand(64, 255),
+                mt_rand(0, 128), mt_rand(64, 255)};
+        }
+    }
+}
+
+static void tiles_frame(WSL_App *app, TilesSprite *sprites, int count) {
+    SDL_Color black = {0, 0, 0, 255};
+    int i;
+    wsl_raster_clear(app->raster, black);
+    for(i = 0; i < count; i++) {
+        wsl_render_sprite(app->queue, RL_PARTICLES, app->spritesheet,
+                sprites[i].blend, &sprites[i].src, &sprites[i].dst,
+                sprites[i].angle, sprites[i].color);
+    }
+    wsl_render_queue_raster(app->queue, app->raster);
+}
+
+static uint64_t tiles_checksum(WSL_Raster *raster) {
+    /* FNV-1a over the framebuffer */
+    uint64_t h = 14695981039346656037ULL;
+    int x, y;
+    for(y = 0; y < raster->h; y++) {
+        for(x = 0; x < raster->w; x++) {
+            h = (h ^ raster->pixels[(y * raster->pitch) + x]) *
+                1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+typedef struct {
+    WSL_App *app;
+    TilesSprite *sprites;
+} TilesData;
+
+static void tiles_frames(void *data, long n) {
+    TilesData *d = data;
+    long i;
+    for(i = 0; i < n; i++) {
+        tiles_frame(d->app, d->sprites, TILES_SPRITES);
+    }
+}
+
+static double tiles_frame_ms(TilesData *d) {
+    /* Median frame time over the repetitions */
+    BenchStats stats = bench_measure(&tiles_frames, d, 1);
+    return stats.median / 1e6;
+}
+
+int bench_tiles(void) {
+    /*
+     * A 20k sprite frame on the WSL_Raster backend, drawn in place, and then
+     * binned into tiles shared by 1, 2, 4 and 8 threads. Every run has to
+     * come out with exactly the same frame. Runs with more threads than the
+     * machine has CPUs are marked, they only show the overhead. With enough
+     * CPUs, TILES_MAX_THREADS threads have to be TILES_MIN_SPEEDUP times
+     * faster than drawing in place.
+     */
+    TilesData d = {bench_app_create(RB_CPU),
+        malloc(sizeof(TilesSprite) * TILES_SPRITES)};
+    WSL_App *app = d.app;
+    int t, cpus = SDL_GetCPUCount();
+    double ms, base, speedup = 0;
+    uint64_t sum, firstsum;
+    bool same = true, scales = true;
+    char name[64];
+
+    if(!app || !d.sprites) {
+        bench_app_destroy(app);
+        free(d.sprites);
+        return 1;
+    }
+    mt_seed(20241012);
+    tiles_scene(d.sprites, TILES_SPRITES);
+    printf("%-36s %10d sprites, %dx%d tiles of %d px\n", "scene",
+            TILES_SPRITES, app->raster->tilesw, app->raster->tilesh,
+            RASTER_TILE);
+    printf("%-36s %10d\n", "CPUs", cpus);
+
+    base = tiles_frame_ms(&d);
+    firstsum = tiles_checksum(app->raster);
+    printf("%-36s %10.2f ms/frame %10s checksum %016llx\n", "in place", base,
+            "", (unsigned long long)firstsum);
+
+    for(t = 1; (t <= TILES_MAX_THREADS) && (t <= MAX_WORKER_THREADS + 1);
+            t *= 2) {
+        app->pool = wsl_pool_create(t);
+        app->raster->pool = app->pool; // Even a pool of 1, to see the cost
+        ms = tiles_frame_ms(&d);
+        sum = tiles_checksum(app->raster);
+        if(sum != firstsum) same = false;
+        speedup = base / ms;
+        snprintf(name, sizeof(name), "tiled %2d thread(s)",
+                wsl_pool_threads(app->pool));
+        printf("%-36s %10.2f ms/frame %9.2fx checksum %016llx%s\n", name, ms,
+                speedup, (unsigned long long)sum,
+                t > cpus ? ", more threads than CPUs" : "");
+        app->raster->pool = NULL;
+        wsl_pool_destroy(app->pool);
+        app->pool = NULL;
+    }
+
+    free(d.sprites);
+    bench_app_destroy(app);
+    printf("Frames %s across thread counts\n", same ? "identical" : "DIFFER, FAIL");
+    if(cpus >= TILES_MAX_THREADS) {
+        scales = speedup >= TILES_MIN_SPEEDUP;
+        printf("%d threads %.2fx in place, %s\n", TILES_MAX_THREADS, speedup,
+                scales ? "scales" : "DOESN'T SCALE, FAIL");
+    } else {
+        printf("Only %d CPU(s), scaling to %d threads not checked\n", cpus,
+                TILES_MAX_THREADS);
+    }
+    return (same && scales) ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <bench.h>
+
+#define TRIG_ANGLES 4096 // Angles per pass, small enough to stay in cache
+#define TRIG_PASSES 2500L
+#define TRIG_SWEEP 10000000L
+
+static volatile float sink; // Keeps the compiler from dropping the loops
+
+static void bench_trig_throughput(void) {
+    /* Same uniform 0..2pi angles the spawners draw, run through each sin/cos
+     * path. Results are summed so nothing gets optimized away. */
+    static float angles[TRIG_ANGLES];
+    static uint32_t bits[TRIG_ANGLES];
+    static float s[TRIG_ANGLES], c[TRIG_ANGLES];
+    RNGBlock *blk = rng_block_global();
+    long i, p;
+    float acc = 0;
+    double start;
+    long iterations = TRIG_ANGLES * TRIG_PASSES;
+
+    for(i = 0; i < TRIG_ANGLES; i++) {
+        bits[i] = rng_block_next(blk);
+        angles[i] = 2*M_PI*rng_block_real(blk);
+    }
+
+    start = bench_now_ns();
+    for(p = 0; p < TRIG_PASSES; p++) {
+        for(i = 0; i < TRIG_ANGLES; i++) {
+            acc += (float)cos(angles[i]) + (float)sin(angles[i]);
+        }
+    }
+    bench_report("(float)cos + (float)sin (double)", bench_now_ns() - start,
+            iterations);
+
+    start = bench_now_ns();
+    for(p = 0; p < TRIG_PASSES; p++) {
+        for(i = 0; i < TRIG_ANGLES; i++) {
+            acc += cosf(angles[i]) + sinf(angles[i]);
+        }
+    }
+    bench_report("cosf + sinf", bench_now_ns() - start, iterations);
+
+    start = bench_now_ns();
+    for(p = 0; p < TRIG_PASSES; p++) {
+        for(i = 0; i < TRIG_ANGLES; i++) {
+            fast_sincosf(angles[i], &s[i], &c[i]);
+        }
+        acc += s[p % TRIG_ANGLES] + c[p % TRIG_ANGLES];
+    }
+    bench_report("fast_sincosf", bench_now_ns() - start, iterations);
+
+    start = bench_now_ns();
+    for(p = 0; p < TRIG_PASSES; p++) {
+        fast_sincos_bulk(angles, s, c, TRIG_ANGLES);
+        acc += s[p % TRIG_ANGLES] + c[p % TRIG_ANGLES];
+    }
+    bench_report("fast_sincos_bulk", bench_now_ns() - start, iterations);
+
+    start = bench_now_ns();
+    for(p = 0; p < TRIG_PASSES; p++) {
+        for(i = 0; i < TRIG_ANGLES; i++) {
+            fast_sincos_bits(bits[i], &s[i], &c[i]);
+        }
+        acc += s[p % TRIG_ANGLES] + c[p % TRIG_ANGLES];
+    }
+    bench_report("fast_sincos_bits", bench_now_ns() - start, iterations);
+    sink = acc;
+}
+
+static bool bench_trig_accuracy(void) {
+    /* Measure the worst error against double precision sin/cos and hold it to
+     * the bounds documented in fasttrig.h */
+    long i;
+    uint32_t u;
+    double a, err, maxerr = 0, maxerr_bits = 0;
+    float s, c;
+    bool pass;
+
+    for(i = 0; i < TRIG_SWEEP; i++) {
+        a = (2.0 * M_PI * i) / TRIG_SWEEP;
+        fast_sincosf((float)a, &s, &c);
+        // Compare against the float angle actually passed in
+        a = (float)a;
+        err = fabs(s - sin(a));
+        if(err > maxerr) maxerr = err;
+        err = fabs(c - cos(a));
+        if(err > maxerr) maxerr = err;
+    }
+    // A few negative and multi-turn angles, same bound
+    for(i = -TRIG_ANGLES; i < TRIG_ANGLES; i++) {
+        a = (float)(i * 0.0123);
+        fast_sincosf((float)a, &s, &c);
+        err = fabs(s - sin(a));
+        if(err > maxerr) maxerr = err;
+        err = fabs(c - cos(a));
+        if(err > maxerr) maxerr = err;
+    }
+    for(i = 0; i < TRIG_ANGLES; i++) {
+        u = (uint32_t)i << (32 - TRIG_TABLE_BITS);
+        a = (2.0 * M_PI * i) / TRIG_TABLE_SIZE;
+        fast_sincos_bits(u, &s, &c);
+        err = fabs(s - sin(a));
+        if(err > maxerr_bits) maxerr_bits = err;
+        err = fabs(c - cos(a));
+        if(err > maxerr_bits) maxerr_bits = err;
+    }
+
+    pass = (maxerr < 5e-7) && (maxerr_bits < 6e-8);
+    printf("fast_sincosf max abs error: %.3g (bound 5e-7)\n", maxerr);
+    printf("fast_sincos_bits max abs error: %.3g (bound 6e-8)\n", maxerr_bits);
+    printf("Accuracy %s\n", pass ? "OK" : "FAIL");
+    return pass;
+}
+
+int bench_trig(void) {
+    fast_trig_init();
+    bench_trig_throughput();
+    return bench_trig_accuracy() ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef AUTOPILOT_H
+#define AUTOPILOT_H
+
+/*
+ * A bot at the keyboard, for runs nobody's watching. Every update it looks
+ * where everything is heading, holds down the arrow keys for the safest move
+ * (towards a pickup, or under something to shoot), and holds space when
+ * there's something above it. After a game over it starts the next game.
+ * Its time is counted in UP_AUTOPILOT.
+ */
+#define AUTOPILOT_MOVES 9 // Standing still, and the eight directions
+#define AUTOPILOT_SAMPLES 4 // Points along the look ahead checked for hits
+#define AUTOPILOT_MAX_THINGS 128 // Enemies, shots and pickups looked at
+
+typedef struct Autopilot Autopilot;
+
+typedef struct {
+    SDL_Rect box; // Hitbox
+    float vx; // How far it moved last update
+    float vy;
+    bool pickup; // Something to go and get
+    bool target; // Something to shoot (otherwise just keep out of the way)
+} AutopilotThing;
+
+struct Autopilot {
+    int wait; // Ticks until the next look, or before moving on between games
+    int laststate; // Game state last update, to see a game end
+    long games; // Games finished
+    long bestscore;
+    long long totalscore;
+    uint64_t gameticks; // Ticks played in all the games, for average survival
+};
+
+Autopilot* autopilot_create(void);
+void autopilot_destroy(Autopilot *bot);
+void autopilot_update(Autopilot *bot, WSL_App *game);
+void autopilot_report(Autopilot *bot, WSL_App *game);
+
+#endif //AUTOPILOT_H
@@ -29,8 +29,82 @@
 
 #define MAX_SND_CHANNELS 8
 
+#define BATCH_MAX_QUADS 4096 // Sprites per SDL_RenderGeometry call, at most
+
+#define NUM_BG_LAYERS 3 // Scrolling background layers, bottom one is opaque
+
+#define TEXT_CACHE_BUCKETS 256 // Hash buckets in the text cache, power of two
+#define TEXT_CACHE_BUDGET (4 * 1024 * 1024) // Bytes of rendered text to keep
+
 #define NUM_HIGHSCORES 8
 
+#define BASE_TICK_RATE 60 // Updates per second the per update amounts
+                          // (speeds, turn rates) are tuned for
+#define MIN_TICK_RATE 10
+#define MAX_TICK_RATE 1000
+
+/* Gameplay timings, in seconds so they last as long at any tick rate */
+#define BLINK_TIME (1 / 60.0f) // Invulnerable ships flash on/off this often
+#define FADE_TIME (1 / 30.0f) // Fading particles lose a bit of alpha this often
+#define PLAYER_FIRE_DELAY (26 / 60.0f) // Between player shots
+#define PLAYER_HIT_INV 2.0f // Invulnerable (and can't shoot) after a hit
+#define PLAYER_SPAWN_INV 1.0f // Same, at the start of a game
+#define UFO_FIRE_DELAY 1.0f // Between UFO shots
+#define UFO_THINK_TIME 1.0f // A UFO might change course this often
+#define PARTICLE_LIFE (26 / 60.0f) // How long a particle lasts
+#define PARTICLE_JITTER 0.08f // Particles start up to this far into their life
+#define PARTICLE_DECAY_START (5 / 60.0f) // Decaying particles restart this
+                                         // far in, higher is shorter lived
+#define FLASH_GROW_TIME 0.08f // Muzzle flash grows for this long...
+#define FLASH_LIFE 0.17f // ...and is gone after this long
+#define ASTEROID_SPAWN_FIRST 0.83f // First asteroid after starting up
+#define ASTEROID_SPAWN_MIN 0.27f // Then one every MIN to MAX seconds
+#define ASTEROID_SPAWN_MAX 0.93f
+#define ASTEROID_SPIN_TIME (1 / 30.0f) // Asteroids turn a bit this often...
+#define ASTEROID_HIT_PAUSE (1 / 30.0f) // ...and stop turning this long when hit
+#define AUTOPILOT_LOOKAHEAD 0.5f // How far ahead the autopilot looks for hits
+#define AUTOPILOT_THINK_TIME 0.1f // Autopilot looks around this often
+#define AUTOPILOT_PAUSE 1.0f // Autopilot waits this long between games
+
+#define HEADLESS_SECONDS 60 // Game time --headless runs, unless --ticks says
+#define TICK_HIST_BUCKETS 16 // Update times histogram, powers of two in us
+#define AUTOPILOT_MARGIN 12 // Pixels of room the autopilot keeps around things
+
+#define MAX_CATCHUP_STEPS 5 // Updates in one frame at most, the rest of the
+                            // time it's behind is dropped
+
+#define MAX_WORKER_THREADS 15 // Worker threads, not counting the main thread
+#define SIM_SLICE_TICKS 60 // Updates a sim runs before it goes back in line
+#define PARTICLE_CHUNK_SIZE 1024 // Particles per job, fixed so results don't
+                                 // depend on the number of threads
+
+/* What draws the frames, picked at wsl_init_sdl */
+typedef enum {
+    RB_SDL, // An SDL_Renderer, accelerated if there is one
+    RB_CPU, // WSL_Raster, straight into a framebuffer on the CPU
+    RB_HEADLESS // Nothing, no window, renderer or sound: simulation only
+} RenderBackends;
+
+/* Parts of an update, timed separately in WSL_Stats */
+typedef enum {
+    UP_ENTITIES, // Entity updates, apart from the particles
+    UP_PARTICLES, // Particle updates on the worker pool
+    UP_CLEANUP, // Removing dead entities, spawning, scrolling
+    UP_SNAPSHOT, // Remembering last positions, and the culling boxes
+    UP_AUTOPILOT, // The autopilot deciding what keys to press
+    UP_MAX
+} UpdatePhases;
+
+/* Render layers, drawn bottom to top */
+typedef enum {
+    RL_BACKGROUND,
+    RL_PARTICLES,
+    RL_ENEMIES, // Enemies, and anything else without a layer of its own
+    RL_PLAYER,
+    RL_HUD,
+    RL_MAX
+} RenderLayers;
+
 enum {
     CH_ANY = -1,
     CH_PLAYER,
@@ -22,5 +22,8 @@
 #define DRAW_H
 
 void draw(WSL_App *game);
+void draw_menu(WSL_App *game);
+void draw_game(WSL_App *game);
+void draw_scores(WSL_App *game);
 
 #endif //DRAW_H
@@ -33,7 +33,8 @@ typedef enum {
     EF_OOB          = 1 << 6,
     EF_INV          = 1 << 7,
     EF_BLIP         = 1 << 8,
-    EF_PICKUP       = 1 << 9
+    EF_PICKUP       = 1 << 9,
+    EF_BURST        = 1 << 10
 } EntityFlags;
 
 typedef struct Entity Entity;
@@ -45,11 +46,16 @@ struct Entity {
     float dx; // The change (delta) in the x,y coordinates
     float dy;
     double angle; // Angle the sprite is rendered at
-    int speed; // How fast the entity is
+    float prevx; // x, y and angle as of the last update, drawn blended
+    float prevy; // towards the current ones (see entity_lerp)
+    double prevangle;
+    SDL_Rect aabb; // Screen box it's drawn somewhere in, see entity_update_aabb
+    int speed; // How fast the entity is, per update at BASE_TICK_RATE
     int cooldown; // Action cooldown timer 
     int frame; // Animation frame timer
     int flags; // EntityFlags
     int health; // How much health the entity has
+    int layer; // RenderLayers, what it's drawn over/under
     uint8_t rgba[4]; // Red, green, blue, alpha 
     SDL_Rect spriterect; // Rect of the player sprite, off spritesheet.xml
     float spritescale; // What scale the sprite should be rendered at
@@ -92,6 +98,12 @@ bool entity_is_projectile(Entity *a);
 bool entity_is_blip(Entity *a);
 bool entity_is_oob(Entity *a);
 bool check_collision_rect(SDL_Rect a, SDL_Rect b);
+void entity_snapshot(Entity *entity);
+void entity_lerp(Entity *entity, float alpha, float *x, float *y,
+        double *angle);
+SDL_Rect entity_box(Entity *entity, float x, float y, double angle);
+void entity_update_aabb(Entity *entity);
+bool entity_on_screen(Entity *entity);
 
 /*****
  * Entity drawing functions - entity.c
@@ -112,6 +124,7 @@ Entity* find_player(WSL_App *game);
  *****/
 Entity* create_projectile(Entity *from, SDL_Rect spriterect);
 void update_projectile(Entity *proj, WSL_App *game);
+void update_projectile_flash(Entity *flash, WSL_App *game);
 void projectile_impact_death(Entity *proj, WSL_App *game);
 
 /*****
@@ -138,7 +151,10 @@ void asteroid_damage(Entity *asteroid, WSL_App *game);
  * Particles - entity_particles.c
  *****/
 void update_particle(Entity *particle, WSL_App *game);
-void particle_death(Entity *particle, WSL_App *game);
+void particle_decay(Entity *particle, WSL_App *game);
+bool particle_offscreen(Entity *particle);
+void update_particles(WSL_App *game, Entity **particles, int count,
+        uint64_t seed);
 void spawn_thruster_particles(Entity *from, WSL_App *game, int qty);
 void spawn_thruster_particle(Entity *from, WSL_App *game);
 void render_particle_test(Entity *particle, WSL_App *game);
@@ -160,7 +176,7 @@ void firework_death(Entity *entity, WSL_App *game);
 /*****
  * Blip text - entity_bliptxt.c
  *****/
-void spawn_bliptxt(int x, int y, WSL_App *game, char *txt, int life, int speed,
+void spawn_bliptxt(int x, int y, WSL_App *game, char *txt, float life, int speed,
         uint8_t r, uint8_t g, uint8_t b, uint8_t a);
 void update_bliptxt(Entity *blip, WSL_App *game);
 void bliptxt_render(Entity *blip, WSL_App *game);
@@ -0,0 +1,46 @@
+/*
+* Toolbox
+* Copyright (C) Zach Wilder 2022-2024
+*
+* This file is a part of Toolbox
+*
+* Toolbox is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Toolbox is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Toolbox.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef FASTTRIG_H
+#define FASTTRIG_H
+
+#include <stdint.h>
+
+/*
+ * Table based float sin/cos. One table of TRIG_TABLE_SIZE sine values covers
+ * a full turn, cosine reads the same table a quarter turn ahead.
+ *
+ * Accuracy:
+ * - fast_sincos_bits() takes the top TRIG_TABLE_BITS of a random number as a
+ *   direction, so angles are quantized to 2pi/4096 (~0.088 degrees). The
+ *   sin/cos of that quantized angle are exact to float rounding (< 6e-8).
+ * - fast_sincosf() linearly interpolates between entries for any angle, max
+ *   absolute error ~3e-7 (h^2/8 with h = 2pi/4096) plus float rounding, good
+ *   to well under a hundredth of a pixel at screen distances. The bound holds
+ *   for any float angle up to a few thousand turns either way.
+ */
+#define TRIG_TABLE_BITS 12
+#define TRIG_TABLE_SIZE (1 << TRIG_TABLE_BITS)
+
+void fast_trig_init(void);
+void fast_sincosf(float angle, float *s, float *c);
+void fast_sincos_bits(uint32_t bits, float *s, float *c);
+void fast_sincos_bulk(const float *angles, float *s, float *c, int n);
+
+#endif //FASTTRIG_H
@@ -48,6 +48,11 @@
 #include <limits.h>
 #include <time.h>
 
+typedef struct {
+    unsigned long mt[624]; /* the array for the state vector */
+    int mti; /* mti==625 means mt[] is not initialized */
+} MT19937;
+
 void init_genrand(unsigned long s);
 void init_by_array(unsigned long init_key[], int key_length);
 unsigned long genrand_int32(void);
@@ -57,12 +62,8 @@ double genrand_real2(void);
 double genrand_real3(void);
 double genrand_res53(void); 
 
-/*
- * Functions below added by Zach Wilder, 2022, with the same conditions as
- * above.
- */
-int mt_rand(int min, int max); 
-bool mt_bool(void); 
-bool mt_chance(int chance);
+/* Reentrant versions, operating on a caller owned state */
+void init_genrand_r(MT19937 *state, unsigned long s);
+unsigned long genrand_int32_r(MT19937 *state);
 
 #endif
@@ -0,0 +1,63 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef REPLAY_H
+#define REPLAY_H
+
+/*
+ * A recorded game: the seed and tick rate it was played with, and the
+ * keyboard each update saw, stored as the scancodes that changed since the
+ * last change. File layout, little endian:
+ *   "SSRP", version (1 byte), tick rate (2), seed (8), ticks (4), state hash
+ *   at the end (8), then one record per tick with changes: ticks since the
+ *   last record, number of scancodes, scancodes (all LEB128 varints).
+ * Recording starts with the next new game and stops when it's over.
+ */
+#define REPLAY_MAGIC "SSRP"
+#define REPLAY_VERSION 1
+#define REPLAY_HEADER_SIZE 27
+
+typedef struct Replay Replay;
+
+struct Replay {
+    FILE *file; // Written as it goes, recording only
+    uint8_t *data; // The whole file, playing back only
+    size_t size;
+    size_t pos; // Next unread byte of data
+    bool recording;
+    bool started; // The game's been seeded and it's counting ticks
+    bool done;
+    uint64_t seed;
+    int tickrate;
+    uint32_t tick; // Ticks so far
+    uint32_t ticks; // Ticks in all, playing back
+    uint32_t last; // Tick of the last change
+    uint32_t next; // Tick of the next change, playing back
+    uint64_t hash; // replay_state_hash at the end
+    bool keys[MAX_KEYBOARD_KEYS]; // Keyboard as of the last tick
+};
+
+Replay* replay_record(const char *path, uint64_t seed, int tickrate);
+Replay* replay_open(const char *path);
+void replay_update(Replay *replay, WSL_App *game);
+bool replay_done(Replay *replay);
+void replay_close(Replay *replay, WSL_App *game);
+uint64_t replay_state_hash(WSL_App *game);
+
+#endif //REPLAY_H
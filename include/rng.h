@@ -0,0 +1,139 @@
+/*
+* Toolbox
+* Copyright (C) Zach Wilder 2022-2024
+*
+* This file is a part of Toolbox
+*
+* Toolbox is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Toolbox is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Toolbox.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <mt19937.h>
+
+/*
+ * The generator behind the mt_* functions is picked at compile time:
+ * - (default) MT19937, the Mersenne Twister in mt19937.c
+ * - RNG_XOSHIRO, xoshiro256** (Blackman/Vigna)
+ * - RNG_PCG32, PCG-XSH-RR 64/32 (O'Neill)
+ * The Makefile sets these from "make RNG=xoshiro" or "make RNG=pcg32".
+ */
+#if defined(RNG_XOSHIRO) && defined(RNG_PCG32)
+#error "Only one of RNG_XOSHIRO and RNG_PCG32 can be defined"
+#endif
+
+typedef struct {
+#if defined(RNG_XOSHIRO)
+    uint64_t s[4];
+#elif defined(RNG_PCG32)
+    uint64_t state;
+    uint64_t inc;
+#else
+    MT19937 mt;
+#endif
+    uint32_t bits; // Bit reservoir for mt_bool/mt_chance
+    int nbits; // Number of unused bits left in the reservoir
+} RNG;
+
+/* 32 bit words rng_pack() writes, the generator's state then the reservoir */
+#if defined(RNG_XOSHIRO)
+#define RNG_PACKED_WORDS (8 + 2)
+#elif defined(RNG_PCG32)
+#define RNG_PACKED_WORDS (4 + 2)
+#else
+#define RNG_PACKED_WORDS (624 + 1 + 2)
+#endif
+
+/*
+ * Block generator for the hot spawn paths: 8 interleaved xoshiro128** lanes
+ * stepped together with SIMD, refilling a whole cache line aligned buffer at
+ * a time. Callers just bump a cursor until it runs dry.
+ */
+#define RNG_BLOCK_LANES 8
+#define RNG_BLOCK_SIZE 256 // Values per refill, multiple of RNG_BLOCK_LANES
+
+typedef struct {
+    _Alignas(64) uint32_t u32[RNG_BLOCK_SIZE]; // Raw 32 bit values
+    _Alignas(64) float real[RNG_BLOCK_SIZE]; // Floats on [0,1)
+    _Alignas(64) uint32_t s[4][RNG_BLOCK_LANES]; // Lane states
+    int u32_cursor; // Next unused value in u32[]
+    int real_cursor; // Next unused value in real[]
+    uint32_t bits; // Bit reservoir for rng_block_bool
+    int nbits;
+} RNGBlock;
+
+/*
+ * Everything the mt_* and mt_fast_* functions draw from. There's one for the
+ * whole process, and a thread can switch to another with rng_use_context().
+ */
+typedef struct {
+    RNG rng;
+    bool seeded;
+    RNGBlock block; // Seeded from rng the first time it's used
+    bool blockseeded;
+} RNGContext;
+
+/*****
+ * RNG
+ *****/
+const char* rng_name(void);
+void rng_seed(RNG *rng, uint64_t seed);
+uint32_t rng_next(RNG *rng);
+uint32_t rng_bounded(RNG *rng, uint32_t range);
+uint32_t rng_bits(RNG *rng, int n);
+double rng_real1(RNG *rng);
+void rng_pack(const RNG *rng, uint32_t *words);
+void rng_unpack(RNG *rng, const uint32_t *words);
+RNG* rng_global(void);
+void rng_use_stream(uint64_t seed);
+void rng_use_global(void);
+RNGContext* rng_use_context(RNGContext *ctx);
+RNGContext* rng_current_context(void);
+
+/*****
+ * RNGBlock
+ *****/
+void rng_block_seed(RNGBlock *blk, uint64_t seed);
+void rng_block_fill_u32(RNGBlock *blk);
+void rng_block_fill_real(RNGBlock *blk);
+int rng_block_range(RNGBlock *blk, int min, int max);
+bool rng_block_bool(RNGBlock *blk);
+RNGBlock* rng_block_global(void);
+
+/* The cursor bump is inlined, only the refill is a real call */
+static inline uint32_t rng_block_next(RNGBlock *blk) {
+    if(blk->u32_cursor >= RNG_BLOCK_SIZE) rng_block_fill_u32(blk);
+    return blk->u32[blk->u32_cursor++];
+}
+
+static inline float rng_block_real(RNGBlock *blk) {
+    if(blk->real_cursor >= RNG_BLOCK_SIZE) rng_block_fill_real(blk);
+    return blk->real[blk->real_cursor++];
+}
+
+/*****
+ * Convenience functions on the global RNG
+ *****/
+void mt_seed(unsigned long seed);
+double mt_real(void);
+int mt_rand(int min, int max);
+bool mt_bool(void);
+bool mt_chance(int chance);
+float mt_fast_real(void);
+int mt_fast_rand(int min, int max);
+bool mt_fast_bool(void);
+
+#endif //RNG_H
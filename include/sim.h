@@ -0,0 +1,35 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SIM_H
+#define SIM_H
+
+/*
+ * Simulation only game instances, many to a process. A sim is a WSL_App
+ * with nothing from SDL in it at all (no window, renderer, textures, sound
+ * or worker pool, and SDL doesn't have to be started), its own random
+ * numbers, and high scores that stay in memory. Any number of them can be
+ * updated at once, on different threads.
+ */
+WSL_App* sim_create(uint64_t seed);
+void sim_destroy(WSL_App *sim);
+uint64_t sim_run(WSL_Pool *pool, WSL_App **sims, int count, long ticks);
+void sim_report(WSL_App **sims, int count, int threads, uint64_t elapsed);
+
+#endif //SIM_H
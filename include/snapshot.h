@@ -0,0 +1,52 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/*
+ * Everything the simulation needs to carry on from where it was: the game
+ * state, score, spawn timer, tick rate, background scroll, keyboard, the
+ * random numbers the game draws from, and every entity in list order (its
+ * AI and text too, function pointers as tags from a table in snapshot.c).
+ * Not what's driving it (a replay or the autopilot), and nothing drawn.
+ * Layout, in the machine's own byte order since a snapshot is only read
+ * back by the same build:
+ *   "SSSN", version (1 byte), sizeof(SnapshotRNG) (4), entities (4), game
+ *   (SnapshotGame), SnapshotRNG and the block generator's unread values,
+ *   then per entity a SnapshotEntity followed by its EntityAI and text if
+ *   it has them.
+ * The buffer is kept between snapshots, so taking one every tick doesn't
+ * allocate once it's grown big enough.
+ */
+#define SNAPSHOT_MAGIC "SSSN"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_HEADER_SIZE 13
+
+typedef struct {
+    uint8_t *data;
+    size_t size; // Bytes used
+    size_t max; // Bytes allocated
+} Snapshot;
+
+bool snapshot_save(WSL_App *game, Snapshot *snap);
+bool snapshot_restore(WSL_App *game, const Snapshot *snap);
+void snapshot_free(Snapshot *snap);
+
+#endif //SNAPSHOT_H
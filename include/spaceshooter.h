@@ -39,6 +39,8 @@
  * Toolbox
  *****/
 #include <mt19937.h>
+#include <rng.h>
+#include <fasttrig.h>
 #include <vec2i.h>
 #include <vec2f.h>
 
@@ -48,9 +50,16 @@
 #include <defs.h>
 #include <entity.h>
 #include <scores.h>
+#include <replay.h>
+#include <autopilot.h>
+#include <wsl_pool.h>
+#include <wsl_clock.h>
 #include <wsl_sdl.h>
 #include <handle_events.h>
 #include <update.h>
 #include <draw.h>
+#include <headless.h>
+#include <sim.h>
+#include <snapshot.h>
 
 #endif //SPACESHOOTER_H
@@ -22,5 +22,15 @@
 #define UPDATE_H
 
 void update(WSL_App *game);
+int update_steps(WSL_App *game, uint64_t *lag, uint64_t step, int maxsteps);
+
+/*****
+ * Tick rate
+ *****/
+void set_tick_rate(WSL_App *game, int tickrate);
+int secs_to_ticks(WSL_App *game, float seconds);
+bool tick_every(WSL_App *game, int tick, float seconds);
+bool tick_blink(WSL_App *game, int tick, float seconds);
+int tick_scale_count(WSL_App *game, int count);
 
 #endif //UPDATE_H
@@ -0,0 +1,55 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef WSL_CLOCK_H
+#define WSL_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NS_PER_MS 1000000ULL
+#define NS_PER_SEC 1000000000ULL
+
+/*
+ * Monotonic nanosecond clock and frame pacing, see wsl_clock.c. Frames are
+ * paced to a fixed target by sleeping most of the way to the deadline and
+ * spinning the rest, the spin margin following how late the sleeps wake up.
+ */
+typedef struct {
+    uint64_t target; // Nanoseconds per frame, 0 doesn't wait at all
+    uint64_t deadline; // When the frame being drawn should end
+    uint64_t spin; // Spin instead of sleep for the last this many ns
+
+    // How late past the deadline the waits ended, in ns
+    uint64_t frames; // Frames that were waited for
+    uint64_t missed; // Frames that were already late, no waiting
+    double mean;
+    double m2; // Sum of squared differences from the mean
+    uint64_t worst;
+} WSL_Clock;
+
+uint64_t wsl_clock_now(void);
+void wsl_clock_sleep(uint64_t ns);
+void wsl_clock_init(WSL_Clock *clock, uint64_t target);
+void wsl_clock_wait(WSL_Clock *clock, uint64_t deadline);
+void wsl_clock_pace(WSL_Clock *clock);
+double wsl_clock_jitter_stddev(WSL_Clock *clock);
+void wsl_clock_reset_stats(WSL_Clock *clock);
+
+#endif //WSL_CLOCK_H
@@ -0,0 +1,56 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WSL_POOL_H
+#define WSL_POOL_H
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <defs.h>
+
+/*
+ * A small fixed pool of SDL worker threads. wsl_pool_run() hands out job
+ * indices 0..count-1 to the workers and the calling thread, and returns once
+ * every job is done. Which thread runs which index is up to chance, so jobs
+ * should only depend on their index.
+ */
+typedef void (*WSL_Job)(void *data, int index);
+
+typedef struct WSL_Pool {
+    SDL_Thread *threads[MAX_WORKER_THREADS];
+    int numthreads; // Worker threads, the caller is one more
+    SDL_mutex *lock;
+    SDL_cond *wake; // New batch (or quit) for the workers
+    SDL_cond *done; // Every worker finished the batch
+    WSL_Job job; // Current batch
+    void *data;
+    int count;
+    SDL_atomic_t next; // Next job index to hand out
+    int finished; // Workers done with the current batch
+    unsigned int batch; // Bumped for every batch
+    bool quit;
+} WSL_Pool;
+
+WSL_Pool* wsl_pool_create(int threads);
+void wsl_pool_destroy(WSL_Pool *pool);
+int wsl_pool_threads(WSL_Pool *pool);
+void wsl_pool_run(WSL_Pool *pool, WSL_Job job, void *data, int count);
+
+#endif //WSL_POOL_H
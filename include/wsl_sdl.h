@@ -24,9 +24,13 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_ttf.h>
+#include <wsl_clock.h>
 
 typedef struct Entity Entity;
 typedef struct Highscore Highscore;
+typedef struct Replay Replay;
+typedef struct Autopilot Autopilot;
+typedef struct WSL_Pool WSL_Pool;
 
 typedef enum {
     GS_MENU,
@@ -38,29 +42,235 @@ typedef enum {
 
 typedef struct {
     SDL_Texture *tex;
-    SDL_Renderer *renderer; // Maybe unnecessary
+    SDL_Renderer *renderer; // NULL on the CPU backend
+    uint32_t *pixels; // Premultiplied ARGB8888, CPU backend only (w*h)
     int w;
     int h;
 } WSL_Texture;
 
+/*
+ * Counters for the F3 overlay. The per frame counts are zeroed at the start of
+ * every draw, and copied to the last_* fields when the frame is presented.
+ * The catch-up counts and update timings are running totals, see
+ * update_steps and update.
+ */
+typedef struct {
+    bool show; // Draw the overlay
+    int drawcalls; // Calls into SDL to draw something, this frame
+    int sprites; // Quads drawn through the batcher, this frame
+    int drawn; // Entities queued up to draw, this frame
+    int culled; // Entities skipped for being off screen, this frame
+    int last_drawcalls;
+    int last_sprites;
+    int last_drawn;
+    int last_culled;
+    int catchups; // Frames that ran more than one update to catch up
+    int capped; // Frames that hit the catch-up limit and dropped time
+    uint64_t dropped; // Nanoseconds of game time dropped, in all
+    uint64_t updates; // Updates run
+    uint64_t phase[UP_MAX]; // Nanoseconds spent in each UpdatePhases
+    uint64_t tickhist[TICK_HIST_BUCKETS]; // Updates taking under 2us, 2-4us..
+    int peakentities; // Most entities alive after an update
+} WSL_Stats;
+
+/*
+ * Sprite batcher, see wsl_batch.c
+ */
+typedef struct {
+    SDL_Renderer *renderer;
+    SDL_Texture *tex; // Texture of the quads queued up
+    SDL_BlendMode blend; // Blend mode they're drawn with
+    SDL_Vertex *verts; // 4 per quad
+    int *indices; // 6 per quad
+    int count; // Quads queued up
+    WSL_Stats *stats; // Where draw calls are counted (or NULL)
+} WSL_Batch;
+
+/*
+ * CPU framebuffer, drawn into instead of an SDL_Renderer on the RB_CPU
+ * backend, see wsl_raster.c. With a worker pool the frame's sprites are
+ * binned into RASTER_TILE square tiles, and the tiles drawn in parallel.
+ */
+#define RASTER_TILE 64 // Tile width and height in pixels
+
+typedef struct {
+    WSL_Texture *tex;
+    SDL_Rect src; // Part of the texture to draw
+    SDL_Rect dst; // Where it goes before turning
+    SDL_Rect bounds; // Pixels it can touch, on screen
+    float s; // Sine and cosine of the angle
+    float c;
+    SDL_BlendMode blend;
+    SDL_Color color;
+} WSL_RasterSprite;
+
+typedef struct {
+    int *sprites; // Sprites touching the tile, in drawing order
+    int count;
+    int max;
+} WSL_RasterTile;
+
+typedef struct {
+    SDL_Surface *surface; // The framebuffer, ARGB8888
+    uint32_t *pixels; // surface->pixels
+    int pitch; // Pixels per row
+    int w;
+    int h;
+    bool bilinear; // Filter scaled and turned sprites (else nearest)
+    WSL_Stats *stats; // Where sprites are counted (or NULL)
+    uint32_t fill; // Color being cleared to
+    WSL_Pool *pool; // Threads to draw the tiles on (or NULL, draw in place)
+    WSL_RasterSprite *sprites; // Sprites binned this frame
+    int numsprites;
+    int maxsprites;
+    WSL_RasterTile *tiles; // tilesw * tilesh bins, row by row
+    int tilesw;
+    int tilesh;
+} WSL_Raster;
+
+/*
+ * Render command queue, see wsl_render.c
+ */
+typedef struct {
+    uint16_t key; // Sort key: layer, blend mode, texture slot
+    uint8_t blend; // Blend mode, as in the key (which may leave it out)
+    SDL_Color color;
+    WSL_Texture *tex;
+    SDL_Rect src; // Part of the texture to draw
+    SDL_Rect dst; // Where on screen it goes
+    float angle; // Degrees clockwise around the middle of dst
+} WSL_RenderCmd;
+
+typedef struct {
+    WSL_RenderCmd *cmds; // This frame's commands, in the order queued
+    uint64_t *order; // Sorted key/index pairs, plus as many again of scratch
+    int count;
+    int max; // Room for this many commands
+    WSL_Texture **textures; // Texture for each slot used this frame
+    int numtextures;
+    WSL_Texture **scratch; // Textures only drawn this frame, reused next
+    int numscratch;
+    int maxscratch;
+} WSL_RenderQueue;
+
+/*
+ * Printable ASCII glyphs pre-rendered into one texture, see wsl_text.c
+ */
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+typedef struct {
+    SDL_Rect rect; // Where the glyph is in the atlas
+    int advance; // How far to move along after drawing it
+} WSL_Glyph;
+
+typedef struct {
+    WSL_Texture *tex;
+    TTF_Font *font; // Font the atlas was built from (for kerning)
+    int height; // Line height
+    WSL_Glyph glyphs[GLYPH_COUNT];
+} WSL_GlyphAtlas;
+
+/*
+ * Rendered strings kept around between frames, see wsl_text.c
+ */
+typedef struct WSL_TextCacheEntry WSL_TextCacheEntry;
+struct WSL_TextCacheEntry {
+    char *str; // The formatted string
+    SDL_Color color;
+    TTF_Font *font;
+    uint32_t hash;
+    WSL_Texture *tex;
+    size_t bytes; // Pixel bytes held by tex
+    unsigned long used; // Frame it was last used
+    WSL_TextCacheEntry *prev; // LRU list, most recently used first
+    WSL_TextCacheEntry *next;
+    WSL_TextCacheEntry *chain; // Next entry in the same hash bucket
+};
+
+typedef struct {
+    WSL_TextCacheEntry *buckets[TEXT_CACHE_BUCKETS];
+    WSL_TextCacheEntry *head; // Most recently used
+    WSL_TextCacheEntry *tail; // Least recently used, evicted first
+    size_t bytes; // Pixel bytes held by all entries
+    size_t budget; // Most bytes to hold before evicting
+    int count;
+    unsigned long frame; // Current frame, used entries aren't evicted
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long evictions;
+} WSL_TextCache;
+
+/*
+ * Sprites pre-rotated at fixed steps for the software renderer, where drawing
+ * a turned quad costs a lot more than a straight copy, see wsl_rotate.c
+ */
+#define ROT_CACHE_ANGLES 36 // Frames per sprite, 10 degrees apart
+#define ROT_CACHE_MAX_SPRITES 32
+
+typedef struct {
+    SDL_Rect src; // The sprite on the spritesheet
+    int y; // Top of its frames in the cache texture
+    int size; // Frames are square, big enough for the sprite at any angle
+    int cols; // Frames per row
+} WSL_RotSprite;
+
+typedef struct {
+    WSL_Texture *tex;
+    WSL_RotSprite sprites[ROT_CACHE_MAX_SPRITES];
+    int count;
+} WSL_RotCache;
+
+/*
+ * A scrolling background layer. The tile is pre-composed into a texture that
+ * covers the whole screen, so drawing it takes two pieces at most.
+ */
+typedef struct {
+    WSL_Texture *tex;
+    float offset; // How far down it has scrolled, wraps at tex->h
+    float speed; // Pixels per second, slower layers look further away
+    uint8_t alpha; // Opaque for the bottom layer, faint for the ones over it
+} WSL_BgLayer;
+
 typedef struct {
     SDL_Window *window; // The SDL Window
     SDL_Surface *screen_surface;
     SDL_Renderer *renderer; // The SDL Renderer
     TTF_Font *font; // SDL Font
     WSL_Texture *spritesheet; // Spritesheet with all the sprites
-    WSL_Texture *bg; // Background texture, will be an array eventually?
+    WSL_BgLayer bg[NUM_BG_LAYERS]; // Background layers, bottom to top
     WSL_Texture *hud_text; // Display text (Needs better name)
+    WSL_GlyphAtlas *glyphs; // Glyphs for the font, NULL falls back to textcache
+    WSL_TextCache *textcache; // Strings the glyph atlas can't draw
+    WSL_RenderQueue *queue; // Everything drawn in a frame, sorted by layer
+    WSL_Batch *batch; // Batches up the sorted sprites and glyphs
+    WSL_Raster *raster; // Draws them on the CPU instead, RB_CPU only
+    WSL_RotCache *rotcache; // Pre-rotated sprites, software renderer only
+    WSL_Stats stats; // Draw counters, F3 shows them
     Mix_Chunk *sounds[SND_MAX]; // Array of sounds
     Mix_Music *music; // Music (obviously)
     bool keyboard[MAX_KEYBOARD_KEYS]; // Keypress "flags" for all keys
     Highscore *scores;
+    Replay *replay; // Input being recorded or played back, or NULL
+    Autopilot *autopilot; // Bot at the keyboard, or NULL
+    RNGContext *rng; // Random numbers of its own (see sim.c), or NULL
+    uint64_t seed; // What the game's random numbers were seeded with
+    uint64_t tick; // Updates run, with seed it picks the particle streams
 
     bool running; // Will likely be replaced with bitflags tlater
     Entity *entities; // Linked list of all the entities
+    Entity **particles; // Particles gathered up each update for the pool
+    int numparticles;
+    int maxparticles;
+    WSL_Pool *pool; // Worker threads for the particles and CPU drawn tiles
+    int backend; // RenderBackends it was started with
     int state; // Current game state
+    float alpha; // How far along to the next update the frame is drawn, 0-1
+    WSL_Clock clock; // Paces the frames, and how well it's keeping up
+    int tickrate; // Updates per second, set_tick_rate changes it
+    float tickscale; // BASE_TICK_RATE / tickrate, per update amounts times this
 
-    int bgoffset; // Scrollin' background offset
     int asteroidspawn; // Asteroid spawn timer
     int score; // The current player score
 } WSL_App;
@@ -68,9 +278,11 @@ typedef struct {
 /*****
  * WSL_App
  *****/
-WSL_App* wsl_init_sdl(void);
+WSL_App* wsl_init_sdl(int backend);
 void wsl_cleanup_sdl(WSL_App *app);
 bool wsl_load_media(WSL_App *app);
+bool wsl_load_background(WSL_App *app);
+void wsl_load_rot_cache(WSL_App *app);
 void wsl_play_sound(WSL_App *app, int id, int channel);
 void wsl_add_entity(WSL_App *app, Entity *entity);
 Entity* wsl_remove_entity(WSL_App *app, Entity *entity);
@@ -81,7 +293,10 @@ void wsl_destroy_entity(WSL_App *app, Entity *entity);
  *****/
 WSL_Texture* create_wsl_texture(SDL_Renderer *renderer);
 void destroy_wsl_texture(WSL_Texture *t);
+bool wsl_texture_loaded(WSL_Texture *t);
+bool wsl_texture_from_surface(WSL_Texture *t, SDL_Surface *surface);
 bool wsl_texture_load(WSL_Texture *t, char *path);
+bool wsl_texture_load_tiled(WSL_Texture *t, char *path, int w, int h);
 bool wsl_texture_load_text(WSL_App *app, WSL_Texture *t, 
         SDL_Color color, char *fstr, ...);
 bool wsl_texture_load_vtext(WSL_App *app, WSL_Texture *t, 
@@ -89,9 +304,82 @@ bool wsl_texture_load_vtext(WSL_App *app, WSL_Texture *t,
 void wsl_text_render(WSL_App *app, int x, int y, char *fstr, ...);
 void wsl_ctext_render(WSL_App *app, SDL_Color color, 
         int x, int y, char *fstr, ...);
+void wsl_vtext_render(WSL_App *app, SDL_Color color, int x, int y,
+        const char *fstr, va_list args);
 void wsl_texture_render(WSL_Texture *t, int x, int y);
 void wsl_texture_render_rect(WSL_Texture *t, int x, int y, SDL_Rect *rect);
 void wsl_texture_render_rect_scaled(WSL_Texture *t, int x, int y, 
         SDL_Rect *rect, float scale);
 
+/*****
+ * WSL_Batch - wsl_batch.c
+ *****/
+WSL_Batch* wsl_batch_create(SDL_Renderer *renderer, WSL_Stats *stats);
+void wsl_batch_destroy(WSL_Batch *batch);
+void wsl_batch_flush(WSL_Batch *batch);
+void wsl_batch_quad(WSL_Batch *batch, SDL_Texture *tex, SDL_BlendMode blend,
+        const SDL_Vertex *v);
+void wsl_batch_sprite(WSL_Batch *batch, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color);
+
+/*****
+ * WSL_Raster - wsl_raster.c
+ *****/
+WSL_Raster* wsl_raster_create(int w, int h, WSL_Stats *stats);
+void wsl_raster_destroy(WSL_Raster *raster);
+void wsl_raster_clear(WSL_Raster *raster, SDL_Color color);
+void wsl_raster_sprite(WSL_Raster *raster, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color);
+void wsl_raster_bin(WSL_Raster *raster, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color);
+void wsl_raster_flush(WSL_Raster *raster);
+void wsl_raster_present(WSL_Raster *raster, SDL_Window *window);
+
+/*****
+ * WSL_RenderQueue - wsl_render.c
+ *****/
+WSL_RenderQueue* wsl_render_queue_create(void);
+void wsl_render_queue_destroy(WSL_RenderQueue *queue);
+void wsl_render_sprite(WSL_RenderQueue *queue, int layer, WSL_Texture *t,
+        SDL_BlendMode blend, const SDL_Rect *src, const SDL_Rect *dst,
+        double angle, SDL_Color color);
+WSL_Texture* wsl_render_queue_scratch(WSL_RenderQueue *queue,
+        SDL_Renderer *renderer);
+void wsl_render_queue_sort(WSL_RenderQueue *queue);
+void wsl_render_queue_submit(WSL_RenderQueue *queue, WSL_Batch *batch);
+void wsl_render_queue_raster(WSL_RenderQueue *queue, WSL_Raster *raster);
+
+/*****
+ * WSL_RotCache - wsl_rotate.c
+ *****/
+WSL_RotCache* wsl_rot_cache_create(SDL_Renderer *renderer, char *path,
+        const SDL_Rect *sprites, int count);
+void wsl_rot_cache_destroy(WSL_RotCache *cache);
+bool wsl_rot_cache_render(WSL_RotCache *cache, WSL_RenderQueue *queue,
+        int layer, const SDL_Rect *src, const SDL_Rect *dst, double angle,
+        SDL_Color color);
+bool wsl_renderer_is_software(SDL_Renderer *renderer);
+
+/*****
+ * WSL_GlyphAtlas - wsl_text.c
+ *****/
+WSL_GlyphAtlas* wsl_glyph_atlas_create(SDL_Renderer *renderer, TTF_Font *font);
+void wsl_glyph_atlas_destroy(WSL_GlyphAtlas *atlas);
+bool wsl_glyph_atlas_covers(WSL_GlyphAtlas *atlas, const char *str);
+bool wsl_glyph_atlas_render(WSL_GlyphAtlas *atlas, WSL_RenderQueue *queue,
+        int layer, SDL_Color color, int x, int y, const char *str);
+
+/*****
+ * WSL_TextCache - wsl_text.c
+ *****/
+WSL_TextCache* wsl_text_cache_create(size_t budget);
+void wsl_text_cache_clear(WSL_TextCache *cache);
+void wsl_text_cache_destroy(WSL_TextCache *cache);
+void wsl_text_cache_next_frame(WSL_TextCache *cache);
+WSL_Texture* wsl_text_cache_get(WSL_App *app, WSL_TextCache *cache,
+        SDL_Color color, const char *str);
+
 #endif //WSL_SDL_H
@@ -0,0 +1,265 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+// Arrow keys held for each move, standing still first so it wins a tie
+static const int autopilot_moves[AUTOPILOT_MOVES][2] = {
+    {0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+    {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+};
+
+/*****
+ * Looking around
+ *****/
+static void autopilot_velocity(Entity *e, float *vx, float *vy) {
+    /* How far it moved last update (wsl_add_entity snapshots anything new,
+     * so it's still until it's been updated once) */
+    *vx = e->x - e->prevx;
+    *vy = e->y - e->prevy;
+}
+
+static SDL_Rect autopilot_grow(SDL_Rect rect, int by) {
+    rect.x -= by;
+    rect.y -= by;
+    rect.w += by * 2;
+    rect.h += by * 2;
+    return rect;
+}
+
+static SDL_Rect autopilot_sweep(SDL_Rect rect, float dx, float dy) {
+    /* Everywhere rect goes moving by dx, dy */
+    if(dx < 0) rect.x += dx;
+    if(dy < 0) rect.y += dy;
+    rect.w += fabsf(dx);
+    rect.h += fabsf(dy);
+    return rect;
+}
+
+static SDL_Rect autopilot_ship_at(SDL_Rect ship, int move, float dist) {
+    /* Where the ship would be holding move for dist pixels, stopped at the
+     * edges the same as update_player stops it */
+    ship.x += autopilot_moves[move][0] * dist;
+    ship.y += autopilot_moves[move][1] * dist;
+    if(ship.x < 0) ship.x = 0;
+    if(ship.x > SCREEN_WIDTH - ship.w) ship.x = SCREEN_WIDTH - ship.w;
+    if(ship.y < 0) ship.y = 0;
+    if(ship.y > SCREEN_HEIGHT - ship.h) ship.y = SCREEN_HEIGHT - ship.h;
+    return ship;
+}
+
+/*****
+ * Driving
+ *****/
+static void autopilot_keys(WSL_App *game, int move, bool fire) {
+    game->keyboard[SDL_SCANCODE_LEFT] = autopilot_moves[move][0] < 0;
+    game->keyboard[SDL_SCANCODE_RIGHT] = autopilot_moves[move][0] > 0;
+    game->keyboard[SDL_SCANCODE_UP] = autopilot_moves[move][1] < 0;
+    game->keyboard[SDL_SCANCODE_DOWN] = autopilot_moves[move][1] > 0;
+    game->keyboard[SDL_SCANCODE_SPACE] = fire;
+}
+
+static int autopilot_look(WSL_App *game, AutopilotThing *things,
+        Entity **player) {
+    /*
+     * One walk down the entity list for the ship, and everything it cares
+     * about: enemies and their shots (how far they moved last update, to see
+     * where they're going), and pickups. Particles are most of the list and
+     * skipped straight away. Returns how many things there were, up to
+     * AUTOPILOT_MAX_THINGS.
+     */
+    Entity *e = NULL;
+    int count = 0;
+    *player = NULL;
+    for(e = game->entities; e; e = e->next) {
+        if((e->update == &update_particle) || !(e->flags & EF_ALIVE)) continue;
+        if(entity_is_player(e)) {
+            if(!entity_is_projectile(e)) *player = e;
+            continue;
+        }
+        if(!(e->flags & (EF_PICKUP | EF_ENEMY)) ||
+                (count == AUTOPILOT_MAX_THINGS)) {
+            continue;
+        }
+        things[count].box = get_hitbox(e);
+        things[count].pickup = (e->flags & EF_PICKUP) != 0;
+        things[count].target = !things[count].pickup &&
+            !entity_is_projectile(e);
+        autopilot_velocity(e, &things[count].vx, &things[count].vy);
+        count += 1;
+    }
+    return count;
+}
+
+static void autopilot_drive(WSL_App *game, Entity *player,
+        AutopilotThing *things, int count) {
+    /*
+     * Every enemy and enemy shot that could get near the ship in the look
+     * ahead is moved along at the speed it's going, and each move is scored
+     * by how soon the ship would run into one (sooner is worse). Of the
+     * safest moves, the one that gets closest to a pickup, or else under the
+     * nearest thing to shoot, wins.
+     */
+    SDL_Rect ship = get_hitbox(player);
+    SDL_Rect box, swept, reach, at;
+    int ahead = secs_to_ticks(game, AUTOPILOT_LOOKAHEAD);
+    float step = player->speed * game->tickscale; // Pixels the ship moves a tick
+    float t, cost, best = 0;
+    float goalx = ship.x, goaly = SCREEN_HEIGHT - ship.h - AUTOPILOT_MARGIN;
+    int pickupdist = -1, targetdist = -1, dist;
+    int danger[AUTOPILOT_MOVES] = {0};
+    int i, k, m, move = 0;
+    bool fire = false;
+
+    reach = autopilot_grow(ship, step * ahead + AUTOPILOT_MARGIN);
+    for(i = 0; i < count; i++) {
+        box = things[i].box;
+        if(things[i].pickup) {
+            dist = abs(box.x - ship.x) + abs(box.y - ship.y);
+            if((pickupdist < 0) || (dist < pickupdist)) {
+                pickupdist = dist;
+                goalx = box.x + (box.w - ship.w) / 2;
+                goaly = box.y;
+            }
+            continue;
+        }
+        if(things[i].target && (box.y + box.h < ship.y)) {
+            // Something to shoot at, shoot if it's lined up
+            if((ship.x + ship.w / 2 >= box.x) &&
+                    (ship.x + ship.w / 2 <= box.x + box.w)) {
+                fire = true;
+            }
+            dist = ship.y - box.y;
+            if((targetdist < 0) || (dist < targetdist)) {
+                targetdist = dist;
+                if(pickupdist < 0) goalx = box.x + (box.w - ship.w) / 2;
+            }
+        }
+        swept = autopilot_sweep(box, things[i].vx * ahead,
+                things[i].vy * ahead);
+        if(!check_collision_rect(swept, reach)) continue;
+        for(k = 1; k <= AUTOPILOT_SAMPLES; k++) {
+            t = (float)ahead * k / AUTOPILOT_SAMPLES;
+            at = autopilot_grow(box, AUTOPILOT_MARGIN);
+            at.x += things[i].vx * t;
+            at.y += things[i].vy * t;
+            for(m = 0; m < AUTOPILOT_MOVES; m++) {
+                if(check_collision_rect(at, autopilot_ship_at(ship, m,
+                                step * t))) {
+                    danger[m] += AUTOPILOT_SAMPLES + 1 - k;
+                }
+            }
+        }
+    }
+
+    // Safest first, then closest to where it wants to be after a step
+    t = (float)ahead / AUTOPILOT_SAMPLES;
+    for(m = 0; m < AUTOPILOT_MOVES; m++) {
+        at = autopilot_ship_at(ship, m, step * t);
+        cost = danger[m] * (SCREEN_WIDTH + SCREEN_HEIGHT) +
+            fabsf(at.x - goalx) + fabsf(at.y - goaly);
+        if((m == 0) || (cost < best)) {
+            best = cost;
+            move = m;
+        }
+    }
+    autopilot_keys(game, move, fire);
+}
+
+/*****
+ * Autopilot
+ *****/
+Autopilot* autopilot_create(void) {
+    Autopilot *bot = calloc(1, sizeof(Autopilot));
+    if(!bot) return NULL;
+    bot->laststate = -1;
+    return bot;
+}
+
+void autopilot_destroy(Autopilot *bot) {
+    free(bot);
+}
+
+void autopilot_update(Autopilot *bot, WSL_App *game) {
+    /*
+     * Called at the start of every update, before a recording sees the
+     * keyboard. Plays the game, taking a look every AUTOPILOT_THINK_TIME,
+     * and between games waits AUTOPILOT_PAUSE at the game over and the menus
+     * before going on to the next one.
+     */
+    AutopilotThing things[AUTOPILOT_MAX_THINGS];
+    Entity *player = NULL;
+    int count;
+    if(!bot) return;
+    if(game->state != bot->laststate) {
+        if(game->state == GS_GAMEOVER) {
+            bot->games += 1;
+            bot->totalscore += game->score;
+            if(game->score > bot->bestscore) bot->bestscore = game->score;
+        }
+        autopilot_keys(game, 0, false);
+        bot->wait = secs_to_ticks(game, AUTOPILOT_PAUSE);
+        bot->laststate = game->state;
+    }
+    switch(game->state) {
+        case GS_GAME:
+            // Keys stay held between looks, like anyone's would
+            bot->gameticks += 1;
+            if(bot->wait) {
+                bot->wait -= 1;
+                break;
+            }
+            bot->wait = secs_to_ticks(game, AUTOPILOT_THINK_TIME) - 1;
+            count = autopilot_look(game, things, &player);
+            if(player) autopilot_drive(game, player, things, count);
+            break;
+        case GS_GAMEOVER:
+            // Any key moves on, once the game over message is gone
+            if(bot->wait) {
+                bot->wait -= 1;
+            } else {
+                game->keyboard[SDL_SCANCODE_SPACE] = true;
+            }
+            break;
+        case GS_MENU:
+        case GS_SCORES:
+            if(bot->wait) {
+                bot->wait -= 1;
+            } else {
+                game->state = GS_NEW;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void autopilot_report(Autopilot *bot, WSL_App *game) {
+    if(!bot) return;
+    if(!bot->games) {
+        printf("Autopilot: no games over yet, %.1f s into the first\n",
+                (double)bot->gameticks / game->tickrate);
+        return;
+    }
+    printf("Autopilot: %ld games, average score %.0f, best %ld, "
+            "%.1f s a game\n", bot->games,
+            (double)bot->totalscore / bot->games, bot->bestscore,
+            (double)bot->gameticks / game->tickrate / bot->games);
+}
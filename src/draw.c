@@ -20,10 +20,13 @@
 
 #include <spaceshooter.h>
 
-void draw_menu(WSL_App *game);
-void draw_game(WSL_App *game);
-void draw_scores(WSL_App *game);
 void draw_gameover(WSL_App *game);
+void draw_background(WSL_App *game);
+Entity* draw_entities(WSL_App *game, int skiplayer);
+void draw_clear(WSL_App *game);
+void draw_submit(WSL_App *game);
+void draw_present(WSL_App *game);
+void draw_stats(WSL_App *game);
 
 void draw(WSL_App *game) {
     switch(game->state) {
@@ -41,32 +44,147 @@ void draw(WSL_App *game) {
     }
 }
 
-void draw_menu(WSL_App *game) {
-    int x = 0, y = 0;
-    Entity *tmp = NULL, *player = NULL;
-    SDL_Color hud_color = {242,242,242,255};
-    // Clear the screen
-    SDL_SetRenderDrawColor(game->renderer, 0xFF, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(game->renderer);
-
-    // Draw the background, tiled across the screen, scrolling along the offset
-    for(y = -1 * game->bg->h; y < SCREEN_HEIGHT; y += game->bg->h) {
-        for(x = 0; x < SCREEN_WIDTH; x += game->bg->w) {
-            //wsl_texture_render(game->bg,x,y);
-            wsl_texture_render(game->bg,x,y+game->bgoffset);
+void draw_background(WSL_App *game) {
+    /*
+     * Each layer covers the whole screen, so scrolling it down by offset is
+     * two pieces: the last offset rows of the texture wrapped around to the
+     * top of the screen, and the rest of it below them. Like the entities,
+     * the offset is drawn blended back towards where the last update left it.
+     */
+    WSL_BgLayer *layer = NULL;
+    SDL_Rect src, dst;
+    SDL_Color color = {255,255,255,255};
+    int i, top, offset;
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        layer = &game->bg[i];
+        if(!wsl_texture_loaded(layer->tex)) continue;
+        color.a = layer->alpha;
+        offset = (int)(layer->offset - (layer->speed / game->tickrate) *
+                (1.0 - game->alpha));
+        if(offset < 0) offset += layer->tex->h;
+        top = offset < SCREEN_HEIGHT ? offset : SCREEN_HEIGHT;
+        if(top > 0) {
+            src = (SDL_Rect){0, layer->tex->h - offset,
+                SCREEN_WIDTH, top};
+            dst = (SDL_Rect){0, 0, SCREEN_WIDTH, top};
+            wsl_render_sprite(game->queue, RL_BACKGROUND, layer->tex,
+                    SDL_BLENDMODE_BLEND, &src, &dst, 0, color);
+        }
+        if(top < SCREEN_HEIGHT) {
+            src = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT - top};
+            dst = (SDL_Rect){0, top, SCREEN_WIDTH, SCREEN_HEIGHT - top};
+            wsl_render_sprite(game->queue, RL_BACKGROUND, layer->tex,
+                    SDL_BLENDMODE_BLEND, &src, &dst, 0, color);
         }
     }
+}
 
-    // Render the entities (and find the player)
-    tmp = game->entities;
+Entity* draw_entities(WSL_App *game, int skiplayer) {
+    /* Queue up every entity on screen, except the ones on skiplayer, and
+     * return the player (on screen or not) if it was passed over */
+    Entity *player = NULL;
+    Entity *tmp = game->entities;
     while(tmp) {
-        if(!entity_is_player(tmp)) {
+        if(tmp->layer == RL_PLAYER) player = tmp;
+        if(tmp->layer == skiplayer) {
+            // Not drawn at all in this state
+        } else if(!entity_on_screen(tmp)) {
+            game->stats.culled += 1;
+        } else {
+            game->stats.drawn += 1;
             tmp->render(tmp, game);
-        } else if (entity_is_player(tmp) && !entity_is_projectile(tmp)) {
-            player = tmp;
+            //hitbox = get_hitbox(tmp);
+            //SDL_RenderDrawRect(game->renderer, &hitbox);
         }
         tmp = tmp->next;
     }
+    return player;
+}
+
+void draw_clear(WSL_App *game) {
+    /* Clear the screen to red, so anything not drawn over stands out */
+    SDL_Color red = {0xFF, 0x00, 0x00, 0xFF};
+    if(game->raster) {
+        wsl_raster_clear(game->raster, red);
+    } else {
+        SDL_SetRenderDrawColor(game->renderer, red.r, red.g, red.b, red.a);
+        SDL_RenderClear(game->renderer);
+    }
+}
+
+void draw_submit(WSL_App *game) {
+    /* Draw what's queued, with whichever backend there is */
+    if(game->raster) {
+        wsl_render_queue_raster(game->queue, game->raster);
+    } else {
+        wsl_render_queue_submit(game->queue, game->batch);
+    }
+}
+
+void draw_present(WSL_App *game) {
+    /* Sort and draw everything queued up this frame, then the stats overlay
+     * if it's on, and put the frame on screen */
+    draw_submit(game);
+    game->stats.last_drawcalls = game->stats.drawcalls;
+    game->stats.last_sprites = game->stats.sprites;
+    game->stats.last_culled = game->stats.culled;
+    game->stats.last_drawn = game->stats.drawn;
+    if(game->stats.show) {
+        draw_stats(game);
+        draw_submit(game);
+    }
+    if(game->raster) {
+        wsl_raster_present(game->raster, game->window);
+    } else {
+        SDL_RenderPresent(game->renderer);
+    }
+    wsl_text_cache_next_frame(game->textcache);
+    game->stats.drawcalls = 0;
+    game->stats.sprites = 0;
+    game->stats.culled = 0;
+    game->stats.drawn = 0;
+}
+
+void draw_stats(WSL_App *game) {
+    /* F3 overlay, numbers are from the frame before the overlay was drawn */
+    SDL_Color color = {242,242,0,200};
+    int y = FONT_SIZE + 10;
+    wsl_ctext_render(game, color, 20, y, "Draw calls: %d  Sprites: %d",
+            game->stats.last_drawcalls, game->stats.last_sprites);
+    y += FONT_SIZE;
+    wsl_ctext_render(game, color, 20, y, "Entities: %d drawn %d culled",
+            game->stats.last_drawn, game->stats.last_culled);
+    y += FONT_SIZE;
+    if(game->clock.target) {
+        wsl_ctext_render(game, color, 20, y,
+                "Pacing: %.0f us late, %.0f us jitter, %lu missed",
+                game->clock.mean / 1000,
+                wsl_clock_jitter_stddev(&game->clock) / 1000,
+                (unsigned long)game->clock.missed);
+        y += FONT_SIZE;
+    }
+    wsl_ctext_render(game, color, 20, y,
+            "Catch-up: %d frames, %d capped, %.1f ms dropped",
+            game->stats.catchups, game->stats.capped,
+            game->stats.dropped / (double)NS_PER_MS);
+    y += FONT_SIZE;
+    if(game->textcache) {
+        wsl_ctext_render(game, color, 20, y, "Text cache: %lu hits %lu misses",
+                game->textcache->hits, game->textcache->misses);
+    }
+}
+
+void draw_menu(WSL_App *game) {
+    int x = 0, y = 0;
+    SDL_Color hud_color = {242,242,242,255};
+    // Clear the screen
+    draw_clear(game);
+
+    // Draw the background
+    draw_background(game);
+
+    // Render the entities (but not the player)
+    draw_entities(game, RL_PLAYER);
 
     // Show the "Menu" (Write some stuff on the screen)
     x = SCREEN_WIDTH / 2;
@@ -86,38 +204,22 @@ void draw_menu(WSL_App *game) {
             "Zach Wilder, 2024");
 
     // Present
-    SDL_RenderPresent(game->renderer);
+    draw_present(game);
 }
 
 void draw_game(WSL_App *game) {
-    Entity *tmp = NULL, *player = NULL;
-    int x = 0, y = 0;
+    Entity *player = NULL;
     SDL_Color hud_color = {242,242,242,255};
     //SDL_Rect hitbox;
 
     // Clear the screen
-    SDL_SetRenderDrawColor(game->renderer, 0xFF, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(game->renderer);
+    draw_clear(game);
 
-    // Draw the background, tiled across the screen, scrolling along the offset
-    for(y = -1 * game->bg->h; y < SCREEN_HEIGHT; y += game->bg->h) {
-        for(x = 0; x < SCREEN_WIDTH; x += game->bg->w) {
-            //wsl_texture_render(game->bg,x,y);
-            wsl_texture_render(game->bg,x,y+game->bgoffset);
-        }
-    }
+    // Draw the background
+    draw_background(game);
 
-    // Render the entities (and find the player)
-    tmp = game->entities;
-    while(tmp) {
-        tmp->render(tmp, game);
-        //hitbox = get_hitbox(tmp);
-        //SDL_RenderDrawRect(game->renderer, &hitbox);
-        if(entity_is_player(tmp) && !entity_is_projectile(tmp)) {
-            player = tmp;
-        }
-        tmp = tmp->next;
-    }
+    // Render the entities, the layers sort out what goes on top
+    player = draw_entities(game, RL_MAX);
 
     // Render the HUD
     if(player) {
@@ -156,37 +258,22 @@ void draw_game(WSL_App *game) {
     }
 
     // Present
-    SDL_RenderPresent(game->renderer);
+    draw_present(game);
 }
 void draw_scores(WSL_App *game) {
     int x = 0, y = 0;
     int i,j;
-    Entity *tmp = NULL, *player = NULL;
     SDL_Color hud_color = {242,242,242,255};
     SDL_Color yellow = {242,242,0,255};
     SDL_Color tmp_color;
     // Clear the screen
-    SDL_SetRenderDrawColor(game->renderer, 0xFF, 0x00, 0x00, 0xFF);
-    SDL_RenderClear(game->renderer);
+    draw_clear(game);
 
-    // Draw the background, tiled across the screen, scrolling along the offset
-    for(y = -1 * game->bg->h; y < SCREEN_HEIGHT; y += game->bg->h) {
-        for(x = 0; x < SCREEN_WIDTH; x += game->bg->w) {
-            //wsl_texture_render(game->bg,x,y);
-            wsl_texture_render(game->bg,x,y+game->bgoffset);
-        }
-    }
+    // Draw the background
+    draw_background(game);
 
-    // Render the entities (and find the player)
-    tmp = game->entities;
-    while(tmp) {
-        if(!entity_is_player(tmp)) {
-            tmp->render(tmp, game);
-        } else if (entity_is_player(tmp) && !entity_is_projectile(tmp)) {
-            player = tmp;
-        }
-        tmp = tmp->next;
-    }
+    // Render the entities (but not the player)
+    draw_entities(game, RL_PLAYER);
     if(game->scores) {
         x = SCREEN_WIDTH / 2;
         y = SCREEN_HEIGHT / 2;
@@ -219,7 +306,7 @@ void draw_scores(WSL_App *game) {
                     "..... %d", game->scores[i].score);
         }
     }
-    SDL_RenderPresent(game->renderer);
+    draw_present(game);
 }
 /*
  * TODO: This function was giving me grief, and I was getting bored with trying
@@ -39,9 +39,14 @@ Entity* create_entity(SDL_Rect spriterect) {
     entity->dy = 0;
     entity->rgba[0]=entity->rgba[1]=entity->rgba[2]=entity->rgba[3]=255;
     entity->angle = 0;
+    entity->prevx = 0;
+    entity->prevy = 0;
+    entity->prevangle = 0;
+    entity->aabb = (SDL_Rect){0,0,0,0};
     entity->cooldown = 0;
     //entity->particletimer = 0;
     entity->health = 0;
+    entity->layer = RL_ENEMIES;
     entity->speed = 0;
     entity->next = NULL;
     entity->prev = NULL;
@@ -172,6 +177,72 @@ bool check_collision_rect(SDL_Rect a, SDL_Rect b) {
     return result; 
 }
 
+void entity_snapshot(Entity *entity) {
+    /* Remember where the entity is before it's updated, for entity_lerp */
+    entity->prevx = entity->x;
+    entity->prevy = entity->y;
+    entity->prevangle = entity->angle;
+}
+
+void entity_lerp(Entity *entity, float alpha, float *x, float *y,
+        double *angle) {
+    /*
+     * Where to draw the entity, alpha of the way from where it was before the
+     * last update to where it is now. The angle turns the short way round,
+     * so going from 350 to 10 passes through 0 instead of back through 180.
+     */
+    double turn = fmod(entity->angle - entity->prevangle, 360);
+    if(turn > 180) turn -= 360;
+    if(turn < -180) turn += 360;
+    *x = entity->prevx + (entity->x - entity->prevx) * alpha;
+    *y = entity->prevy + (entity->y - entity->prevy) * alpha;
+    *angle = entity->prevangle + turn * alpha;
+}
+
+SDL_Rect entity_box(Entity *entity, float x, float y, double angle) {
+    /*
+     * Screen box the entity's sprite covers drawn at x,y. A turned sprite
+     * could point any way, so it gets a square around its middle as wide as
+     * the sprite's diagonal.
+     */
+    SDL_Rect box;
+    float w = entity->spriterect.w * entity->spritescale;
+    float h = entity->spriterect.h * entity->spritescale;
+    float side;
+    if(angle) {
+        side = sqrtf((w * w) + (h * h));
+        x += (w - side) / 2;
+        y += (h - side) / 2;
+        w = h = side;
+    }
+    box.x = (int)floorf(x);
+    box.y = (int)floorf(y);
+    box.w = (int)ceilf(x + w) - box.x;
+    box.h = (int)ceilf(y + h) - box.y;
+    return box;
+}
+
+void entity_update_aabb(Entity *entity) {
+    /*
+     * Cache the box covering the entity both before and after the last update,
+     * so wherever entity_lerp puts it between the two it's inside.
+     */
+    SDL_Rect a = entity_box(entity, entity->prevx, entity->prevy,
+            entity->prevangle);
+    SDL_Rect b = entity_box(entity, entity->x, entity->y, entity->angle);
+    SDL_UnionRect(&a, &b, &entity->aabb);
+}
+
+bool entity_on_screen(Entity *entity) {
+    /*
+     * Check if any of the entity's cached box is on screen. Blips are text,
+     * which the box knows nothing about, so they always count.
+     */
+    SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    if(entity_is_blip(entity)) return true;
+    return SDL_HasIntersection(&entity->aabb, &screen);
+}
+
 /*****
  * Entity drawing functions
  * (Might move to draw.h)
@@ -180,22 +251,26 @@ void entity_render(Entity *entity, WSL_App *game) {
     /*
      * Render an entity, with the sprite scaled based on the entity's
      * "spritescale", and rotated based on the entities "angle". Also modulate
-     * the color/alpha of the entity based on an entities rgba.
+     * the color/alpha of the entity based on an entities rgba. The sprite is
+     * queued on the entity's layer, not drawn right away. On the software
+     * renderer turned sprites come pre-rotated out of the rotation cache.
      */
     SDL_Rect renderquad;
-    renderquad.x = entity->x;
-    renderquad.y = entity->y;
+    SDL_Color color = {entity->rgba[0], entity->rgba[1], entity->rgba[2],
+        entity->rgba[3]};
+    float x, y;
+    double angle;
+    entity_lerp(entity, game->alpha, &x, &y, &angle);
+    renderquad.x = x;
+    renderquad.y = y;
     renderquad.w = entity->spriterect.w * entity->spritescale;
     renderquad.h = entity->spriterect.h * entity->spritescale;
-    SDL_SetTextureColorMod(game->spritesheet->tex, entity->rgba[0], entity->rgba[1],
-            entity->rgba[2]);
-    SDL_SetTextureAlphaMod(game->spritesheet->tex, entity->rgba[3]);
-    if(entity->angle) {
-        SDL_RenderCopyEx(game->renderer, game->spritesheet->tex, 
-                &entity->spriterect, &renderquad,
-                entity->angle, NULL, SDL_FLIP_NONE);
-    } else {
-        SDL_RenderCopy(game->renderer, game->spritesheet->tex, 
-                &entity->spriterect, &renderquad);
+    if(angle && wsl_rot_cache_render(game->rotcache, game->queue,
+                entity->layer, &entity->spriterect, &renderquad, angle,
+                color)) {
+        return;
     }
+    wsl_render_sprite(game->queue, entity->layer, game->spritesheet,
+            SDL_BLENDMODE_BLEND, &entity->spriterect, &renderquad,
+            angle, color);
 }
@@ -89,19 +89,19 @@ void update_asteroid(Entity *asteroid, WSL_App *game) {
     Entity *other = NULL;
     SDL_Rect hitbox = get_hitbox(asteroid);
     SDL_Rect otherbox;
+    if(!((asteroid->flags & EF_COOLDOWN) == EF_COOLDOWN)) {
+        asteroid->angle += 5;
+        asteroid->cooldown = secs_to_ticks(game, ASTEROID_SPIN_TIME);
+        asteroid->flags |= EF_COOLDOWN;
+    }
+    asteroid->x += asteroid->dx * asteroid->speed * game->tickscale;
+    asteroid->y += asteroid->dy * asteroid->speed * game->tickscale;
+    // Out of bounds in the update it gets there, not the one after
     if((asteroid->x <= 0) || (asteroid->x >= SCREEN_WIDTH) || 
             (asteroid->y >= SCREEN_HEIGHT)) {
         asteroid->flags &= ~EF_ALIVE;
         asteroid->flags |= EF_OOB;
     }
-
-    if(!((asteroid->flags & EF_COOLDOWN) == EF_COOLDOWN)) {
-        asteroid->angle += 5;
-        asteroid->cooldown = 1;
-        asteroid->flags |= EF_COOLDOWN;
-    }
-    asteroid->x += asteroid->dx * asteroid->speed;
-    asteroid->y += asteroid->dy * asteroid->speed;
     // Check for contact with player
     other = game->entities;
     while(other) {
@@ -139,13 +139,15 @@ void spawn_asteroid(WSL_App *game) {
     ast->y = 0;
     ast->dy = 1;
     wsl_add_entity(game, ast); // Add asteroid to game list
-    game->asteroidspawn = mt_rand(15,55); // Set timer to spawn a new asteroid
+    game->asteroidspawn = mt_rand(secs_to_ticks(game, ASTEROID_SPAWN_MIN),
+            secs_to_ticks(game, ASTEROID_SPAWN_MAX)); // Set timer to spawn a new asteroid
 }
 
 void spawn_small_asteroid(Entity *entity, WSL_App *game) {
     /* Create a small asteroid with a random trajectory/distance from a point,
      * moving at a random dx/dy from that point */
-    float angle = 0.0;
+    RNGBlock *rng = rng_block_global(); // Random numbers come off the block
+    float sina = 0.0, cosa = 0.0;
     float radius = 0.0;
     int max_radius = 4;
     int min_velocity = 2;
@@ -153,7 +155,7 @@ void spawn_small_asteroid(Entity *entity, WSL_App *game) {
     float x = entity->x;
     float y = entity->y;
     SDL_Rect spriterect;
-    if(mt_bool()) {
+    if(rng_block_bool(rng)) {
         //<SubTexture name="meteorBrown_med1.png" x="651" y="447" width="43" height="43"/>
         spriterect.x = 651;
         spriterect.y = 447;
@@ -167,17 +169,17 @@ void spawn_small_asteroid(Entity *entity, WSL_App *game) {
         spriterect.h = 40;
     }
     Entity *asteroid = create_entity(spriterect);
-    angle = 2*M_PI*(float)genrand_real1(); // angle to move about origin x,y
-    radius = max_radius*(float)genrand_real1(); // random distance from origin
+    fast_sincos_bits(rng_block_next(rng), &sina, &cosa); // random direction about origin x,y
+    radius = max_radius*rng_block_real(rng); // random distance from origin
     // Polar to cartesian coordinates
-    asteroid->x = x + radius*(float)cos(angle); // x=r*cosA
-    asteroid->y = y + radius*(float)sin(angle); // y=r*sinA
+    asteroid->x = x + radius*cosa; // x=r*cosA
+    asteroid->y = y + radius*sina; // y=r*sinA
     //Random velocity along the x axis
-    asteroid->dx = min_velocity + (max_velocity*genrand_real1());
-    if(mt_bool()) asteroid->dx *= -1; // about half move left, other half right
+    asteroid->dx = min_velocity + (max_velocity*rng_block_real(rng));
+    if(rng_block_bool(rng)) asteroid->dx *= -1; // about half move left, other half right
     //Random velocity along the y axis
-    asteroid->dy = min_velocity + (max_velocity*genrand_real1());
-    if(mt_bool()) asteroid->dy *= -1; // about half move up, other half down
+    asteroid->dy = min_velocity + (max_velocity*rng_block_real(rng));
+    if(rng_block_bool(rng)) asteroid->dy *= -1; // about half move up, other half down
     asteroid->speed = 1;
     asteroid->flags = EF_ALIVE | EF_ENEMY;
     asteroid->render = &entity_render;
@@ -191,7 +193,7 @@ void spawn_small_asteroid(Entity *entity, WSL_App *game) {
 void asteroid_damage(Entity *asteroid, WSL_App *game) {
     asteroid->health -= 1;
     asteroid->speed -= 2;
-    asteroid->cooldown += 2;
+    asteroid->cooldown += secs_to_ticks(game, ASTEROID_HIT_PAUSE); // Stops turning
     if(asteroid->health <= 0) {
         asteroid->flags &= ~EF_ALIVE;
     }
@@ -19,7 +19,7 @@
 */
 #include <spaceshooter.h>
 
-void spawn_bliptxt(int x, int y, WSL_App *game, char *txt, int life, int speed,
+void spawn_bliptxt(int x, int y, WSL_App *game, char *txt, float life, int speed,
         uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
     /*
      * Creates a short lived entity that is displayed as the string "txt", that
@@ -28,13 +28,14 @@ void spawn_bliptxt(int x, int y, WSL_App *game, char *txt, int life, int speed,
     SDL_Rect spriterect = {0,0,0,0};
     Entity *blip = create_entity(spriterect);
     blip->flags = EF_ALIVE | EF_BLIP;
+    blip->layer = RL_HUD;
     blip->update = &update_bliptxt;
     blip->render = &bliptxt_render;
     blip->rgba[0] = r;
     blip->rgba[1] = g;
     blip->rgba[2] = b;
     blip->rgba[3] = a;
-    blip->cooldown = life; // How long the blip lasts before disappearing
+    blip->cooldown = secs_to_ticks(game, life); // Seconds until it disappears
     blip->speed = speed; // The smaller this number is, the less blinky
     blip->x = x;
     blip->y = y;
@@ -62,7 +63,8 @@ void update_bliptxt(Entity *blip, WSL_App *game) {
 void bliptxt_render(Entity *blip, WSL_App *game) {
     SDL_Color hud_color = {blip->rgba[0],blip->rgba[1],
         blip->rgba[2],blip->rgba[3]};
-    int x = blip->x;
-    int y = blip->y;
+    float x, y;
+    double angle;
+    entity_lerp(blip, game->alpha, &x, &y, &angle);
     wsl_ctext_render(game, hud_color,x,y,blip->txt);
 }
@@ -37,21 +37,23 @@ void spawn_explosion_particle(int x, int y, WSL_App *game, SDL_Rect spriterect,
      *   away from the origin
      * - r/g/b/a: red, green, blue, alpha colors - [0,255]
      */
-    float angle = 0.0;
+    RNGBlock *rng = rng_block_global(); // Random numbers come off the block
+    float sina = 0.0, cosa = 0.0;
     float radius = 0.0;
     Entity *particle = create_entity(spriterect); // create generic entity
-    angle = 2*M_PI*(float)genrand_real1(); // angle to move about origin x,y
-    radius = max_radius*(float)genrand_real1(); // random distance from origin
-    particle->flags = EF_ALIVE; // Particles gotta start alive
+    fast_sincos_bits(rng_block_next(rng), &sina, &cosa); // random direction about origin x,y
+    radius = max_radius*rng_block_real(rng); // random distance from origin
+    particle->flags = EF_ALIVE | EF_BURST; // Alive, and decays when done
+    particle->layer = RL_PARTICLES;
     // Polar to cartesian coordinates
-    particle->x = x + radius*(float)cos(angle); // x=r*cosA
-    particle->y = y + radius*(float)sin(angle); // y=r*sinA
+    particle->x = x + radius*cosa; // x=r*cosA
+    particle->y = y + radius*sina; // y=r*sinA
     //Random velocity along the x axis
-    particle->dx = min_velocity + (max_velocity*genrand_real1());
-    if(mt_bool()) particle->dx *= -1; // about half move left, other half right
+    particle->dx = min_velocity + (max_velocity*rng_block_real(rng));
+    if(rng_block_bool(rng)) particle->dx *= -1; // about half move left, other half right
     //Random velocity along the y axis
-    particle->dy = min_velocity + (max_velocity*genrand_real1());
-    if(mt_bool()) particle->dy *= -1; // about half move up, other half down
+    particle->dy = min_velocity + (max_velocity*rng_block_real(rng));
+    if(rng_block_bool(rng)) particle->dy *= -1; // about half move up, other half down
     particle->speed = 1; // Basic speed
     particle->angle = 45; // Angle here is the SPRITE angle, should be passed in?
     particle->spritescale = spritescale; // Scale of the sprite used for the particle
@@ -59,10 +61,9 @@ void spawn_explosion_particle(int x, int y, WSL_App *game, SDL_Rect spriterect,
     particle->rgba[1] = g;
     particle->rgba[2] = b;
     particle->rgba[3] = a;
-    particle->frame = mt_rand(0,5); // Each particle lives for a diffent time
+    particle->frame = rng_block_range(rng,0,secs_to_ticks(game, PARTICLE_JITTER)); // Each particle lives for a diffent time
     particle->update = &update_particle; // Update function
     particle->render = &entity_render; // Basic entity render
-    particle->deathfunc = &particle_death; // Gravity decay
     wsl_add_entity(game, particle); // Add particle to game list
 }
 
@@ -71,13 +72,13 @@ void spawn_explosion(int x, int y, WSL_App *game) {
     int max_radius = 20;
     int min_velocity = 0;
     int max_velocity = 10;
-    float spritescale = 0.25 + genrand_real1();
+    float spritescale = 0.25 + mt_real();
     int i = 0;
     //SDL_Rect spriterect = {222,84,25,24}; //star2
     //SDL_Rect spriterect = {628,681,25,24}; //star1
     SDL_Rect spriterect = {576,300,24,24}; //star3
     for(i = 0; i < num_particles; i++) {
-        spritescale = 0.25 + (0.75*genrand_real1());
+        spritescale = 0.25 + (0.75*mt_real());
         spawn_explosion_particle(x, y, game, spriterect,
                 spritescale, max_radius, min_velocity, max_velocity,
                 mt_rand(200,255),mt_rand(25,125),mt_rand(0,10),mt_rand(25,200));
@@ -190,7 +191,7 @@ void spawn_asteroid_explosion(int x, int y, WSL_App *game) {
             case 3: spriterect = small1; break;
             default: spriterect = small2; break;
         }
-        spritescale = 0.75 * genrand_real1();
+        spritescale = 0.75 * mt_real();
         spawn_explosion_particle(x, y, game, spriterect,
                 spritescale, max_radius, min_velocity, max_velocity,
                 255,255,255,mt_rand(25,200));
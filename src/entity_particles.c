@@ -20,50 +20,102 @@
 #include <spaceshooter.h>
 
 void update_particle(Entity *particle, WSL_App *game) {
+    /*
+     * Particles live in two phases in the same entity: a particle flagged
+     * EF_BURST flies out from where it was spawned, and when its time is up it
+     * turns into a slower "decay" particle right where it is (see
+     * particle_decay). Particles without EF_BURST just die at the end.
+     */
     particle->frame += 1; //Update frame
-    particle->x += particle->dx * particle->speed; //Update x position
-    particle->y += particle->dy * particle->speed; //Update y position
+    particle->x += particle->dx * particle->speed * game->tickscale; //Update x position
+    particle->y += particle->dy * particle->speed * game->tickscale; //Update y position
     
     if(particle->angle) {
         //If the particle starts off angled, spin it
-        particle->angle += 45;
+        particle->angle += 45 * game->tickscale;
     }
-    if((particle->rgba[3] > 25) && (particle->frame % 2 == 0)) {
+    if((particle->rgba[3] > 25) && tick_every(game, particle->frame, FADE_TIME)) {
         particle->rgba[3] -= 5;
     }
 
-    if(particle->frame > 25) {
-        // Kill the particle after 25 frames. The 25 should be another variable,
-        // possibly set the particles->health to 25 and then compare it that
-        // way?
+    if(particle_offscreen(particle)) {
+        // Nothing turns a particle around, so it's never coming back
         particle->flags &= ~EF_ALIVE;
+        particle->flags |= EF_OOB;
+        return;
+    }
+
+    if(particle->frame >= secs_to_ticks(game, PARTICLE_LIFE)) {
+        // End of this phase after PARTICLE_LIFE. Could be set per particle,
+        // possibly in particle->health and then compare it that way?
+        if(particle->flags & EF_BURST) {
+            particle_decay(particle, game);
+        } else {
+            particle->flags &= ~EF_ALIVE;
+        }
     }
 }
 
-void particle_death(Entity *particle, WSL_App *game) {
-    // Spawn a fancy NEW particle to replace this particle that "falls" down the
-    // screen (with "gravity")
+bool particle_offscreen(Entity *particle) {
+    /*
+     * Check if the particle is all the way off one side of the screen, and
+     * still heading away from it. Decaying keeps the direction it was going,
+     * only slower.
+     */
+    SDL_Rect box = entity_box(particle, particle->x, particle->y,
+            particle->angle);
+    return ((box.x + box.w < 0) && (particle->dx <= 0)) ||
+        ((box.x > SCREEN_WIDTH) && (particle->dx >= 0)) ||
+        ((box.y + box.h < 0) && (particle->dy <= 0)) ||
+        ((box.y > SCREEN_HEIGHT) && (particle->dy >= 0));
+}
+
+void particle_decay(Entity *particle, WSL_App *game) {
+    // Turn a burst particle into a "decay" particle that "falls" down the
+    // screen (with "gravity"). Sprite, scale, color and position carry over.
     // TODO FINISH this function tlater -- tinker around with dx/dy/speed
-    Entity *decay = create_entity(particle->spriterect);
-    decay->x = particle->x;
-    decay->y = particle->y;
-    
-    decay->dy = particle->dy / (mt_rand(2,8)); // The closer this is to 1 the more vertical it goes
-    //if(decay->dy <= 0) decay->dy *= -1; // Make sure the "dead" particles "fall"
-    decay->dx = particle->dx / (mt_rand(4,8)); // The closer this is to 1 the more horizontal it goes
+    particle->dy = particle->dy / (mt_rand(2,8)); // The closer this is to 1 the more vertical it goes
+    //if(particle->dy <= 0) particle->dy *= -1; // Make sure the "dead" particles "fall"
+    particle->dx = particle->dx / (mt_rand(4,8)); // The closer this is to 1 the more horizontal it goes
     
-    decay->speed = mt_rand(1,3); // The farther apart these numbers are the weirder it looks
-    decay->angle = 45;
-    decay->spritescale = particle->spritescale;
-    decay->rgba[0] = particle->rgba[0];
-    decay->rgba[1] = particle->rgba[1];
-    decay->rgba[2] = particle->rgba[2];
-    decay->rgba[3] = particle->rgba[3];// -10;
-    decay->frame = 5; // Higher this is, the shorter lived the "dead" particle (particles "die" after 25 frames)
-    decay->flags = EF_ALIVE;
-    decay->update = &update_particle;
-    decay->render = &entity_render;
-    wsl_add_entity(game, decay);
+    particle->speed = mt_rand(1,3); // The farther apart these numbers are the weirder it looks
+    particle->angle = 45;
+    particle->frame = secs_to_ticks(game, PARTICLE_DECAY_START); // Particles "die" after PARTICLE_LIFE
+    particle->flags &= ~EF_BURST; // Next time around it dies
+}
+
+typedef struct {
+    WSL_App *game;
+    Entity **particles;
+    int count;
+    uint64_t seed;
+} ParticleBatch;
+
+static void update_particle_chunk(void *data, int chunk) {
+    /* Update one fixed size chunk of particles, drawing any random numbers
+     * from the chunk's own stream */
+    ParticleBatch *batch = data;
+    int i = chunk * PARTICLE_CHUNK_SIZE;
+    int end = i + PARTICLE_CHUNK_SIZE;
+    if(end > batch->count) end = batch->count;
+    rng_use_stream(batch->seed + chunk);
+    for(; i < end; i++) {
+        batch->particles[i]->update(batch->particles[i], batch->game);
+    }
+    rng_use_global();
+}
+
+void update_particles(WSL_App *game, Entity **particles, int count,
+        uint64_t seed) {
+    /*
+     * Update a batch of particles on the worker pool. Particles never touch
+     * each other or the entity list, so they split into chunks of
+     * PARTICLE_CHUNK_SIZE. Chunk n draws from a stream seeded with seed + n, so
+     * the results are the same however many threads there are.
+     */
+    ParticleBatch batch = {game, particles, count, seed};
+    int chunks = (count + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+    wsl_pool_run(game->pool, &update_particle_chunk, &batch, chunks);
 }
 
 void spawn_thruster_particles(Entity *from, WSL_App *game, int qty) {
@@ -79,8 +131,10 @@ void spawn_thruster_particle(Entity *from, WSL_App *game) {
      * send it off in a short "cone" towards the bottom of the screen. Should be
      * called multiple times for maximum effect.
      */
-    int max_velocity = mt_rand(2,6); // Fiddle with this, should be a random number
+    RNGBlock *rng = rng_block_global(); // Random numbers come off the block
+    int max_velocity = rng_block_range(rng,2,6); // Fiddle with this, should be a random number
     int min_velocity = 0; // Fiddle with this, should be a random number
+    int dx = 0;
     float x = from->x + ((from->spriterect.w * from->spritescale)/2); //Middle of from
     float y = from->y + (from->spriterect.h * from->spritescale); //Bottom of from
 	//<SubTexture name="star1.png" x="628" y="681" width="25" height="24"/>
@@ -88,34 +142,38 @@ void spawn_thruster_particle(Entity *from, WSL_App *game) {
 	//<SubTexture name="star3.png" x="576" y="300" width="24" height="24"/>
     SDL_Rect spriterect = {628,681,25,24};
     Entity *particle = create_entity(spriterect); // create generic entity
-    particle->x = x + mt_rand(-5,5); //Slight deviation so it's slightly different
+    particle->x = x + rng_block_range(rng,-5,5); //Slight deviation so it's slightly different
     particle->y = y;
     //particle->spritescale = 0.083; //Tiny, about 2px EH
     //particle->spritescale = 0.5; //Huge, about 12px COOL
     particle->spritescale = 0.25; //About 6px (sweet spot!)
-    particle->flags = EF_ALIVE; // Particles gotta start alive
+    particle->flags = EF_ALIVE | EF_BURST; // Particles gotta start alive
+    particle->layer = RL_PARTICLES;
     //Send the particles down and maybe to the left/right
-    particle->dy = min_velocity + (max_velocity*genrand_real1());
+    particle->dy = min_velocity + (max_velocity*rng_block_real(rng));
+    // Numerator drawn first, on its own line so every compiler agrees
     if(from->angle < 0) {
         //From is pointed left, shoot particle right
-        particle->dx = mt_rand(2,12) / mt_rand(2,4);
+        dx = rng_block_range(rng,2,12);
+        particle->dx = dx / rng_block_range(rng,2,4);
     } else if (from->angle > 0) {
         //From is pointed right, shoot particle left
-        particle->dx = mt_rand(2,12) / mt_rand(-4,-2);
+        dx = rng_block_range(rng,2,12);
+        particle->dx = dx / rng_block_range(rng,-4,-2);
     } else {
         //Shoot particle down
-        particle->dx = mt_rand(-1,1) / (mt_rand(1,4)); 
+        dx = rng_block_range(rng,-1,1);
+        particle->dx = dx / (rng_block_range(rng,1,4)); 
     }
     particle->speed = 1; //Basic speed
     particle->angle = 45; // Angle here is the SPRITE angle, should be passed in?
-    particle->rgba[0] = mt_rand(225,255); // Red, green, blue, and alpha used for the particle
-    particle->rgba[1] = mt_rand(0,155); // Make it orangeish? Could be passed in.
+    particle->rgba[0] = rng_block_range(rng,225,255); // Red, green, blue, and alpha used for the particle
+    particle->rgba[1] = rng_block_range(rng,0,155); // Make it orangeish? Could be passed in.
     particle->rgba[2] = 0;
-    particle->rgba[3] = mt_rand(100,200);
-    particle->frame = mt_rand(0,5); // Each particle lives for a diffent time
+    particle->rgba[3] = rng_block_range(rng,100,200);
+    particle->frame = rng_block_range(rng,0,secs_to_ticks(game, PARTICLE_JITTER)); // Each particle lives for a diffent time
     particle->update = &update_particle; // Update function
     particle->render = &entity_render; // Basic entity render
-    particle->deathfunc = &particle_death; // Gravity decay
     wsl_add_entity(game, particle);
 }
 
@@ -152,8 +210,9 @@ Entity* create_particle_test(Entity *from, WSL_App *game) {
     // Randomly create a particle around the "from" entity
     particle->x = from->x;// + (mt_rand(-10,10));
     particle->y = from->y;// + (mt_rand(20,30));
-    particle->frame = mt_rand(0,5); // Start the frame at a random spot 
+    particle->frame = mt_rand(0,secs_to_ticks(game, PARTICLE_JITTER)); // Start the frame at a random spot 
     particle->flags = EF_ALIVE;
+    particle->layer = RL_PARTICLES;
     particle->rgba[3] = 75; // Semi transparent
     particle->spritescale = 0.75;
     //particle->angle = 180;
@@ -174,8 +174,8 @@ void update_pickup(Entity *pickup, WSL_App *game) {
     }
     
     // Update the pickup's position
-    pickup->x += pickup->dx * pickup->speed;
-    pickup->y += pickup->dy * pickup->speed;
+    pickup->x += pickup->dx * pickup->speed * game->tickscale;
+    pickup->y += pickup->dy * pickup->speed * game->tickscale;
 }
 
 void shield_pickup_death(Entity *pickup, WSL_App *game) {
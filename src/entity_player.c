@@ -28,6 +28,7 @@ Entity* create_player(SDL_Rect spriterect) {
      */
     Entity *player = create_entity(spriterect);
     player->flags = EF_ALIVE | EF_PLAYER;
+    player->layer = RL_PLAYER;
     player->update = &update_player;
     player->render = &player_render;
     player->take_damage = &player_damage;
@@ -63,8 +64,8 @@ void update_player(Entity *player, WSL_App *game) {
         player->angle = 0;
     }
 
-    player->x += player->dx;
-    player->y += player->dy;
+    player->x += player->dx * game->tickscale;
+    player->y += player->dy * game->tickscale;
 
     if(player->x <= 0) player->x = 0;
     if(player->x >= (SCREEN_WIDTH - w)){
@@ -80,7 +81,7 @@ void update_player(Entity *player, WSL_App *game) {
     if(game->keyboard[SDL_SCANCODE_UP] || game->keyboard[SDL_SCANCODE_LEFT] || 
      game->keyboard[SDL_SCANCODE_RIGHT] ) {
         //create_particle_test(player,game);
-        spawn_thruster_particles(player,game,mt_rand(2,10));
+        spawn_thruster_particles(player,game,tick_scale_count(game,mt_rand(2,10)));
     }
 
     // Fire lasers!
@@ -109,13 +110,13 @@ void update_player(Entity *player, WSL_App *game) {
         proj->spritescale = player->spritescale;
         wsl_add_entity(game, proj); // Add projectile to list
         player->flags |= EF_COOLDOWN; // Turn on cooldown flag
-        player->cooldown = 25; // Start cooldown timer, entities should have a "firerate"
+        player->cooldown = secs_to_ticks(game, PLAYER_FIRE_DELAY); // Start cooldown timer, entities should have a "firerate"
         wsl_play_sound(game, SND_PLAYER_FIRE, CH_PLAYER);
     }
     if((player->flags & EF_INV) == EF_INV) {
         player->frame -= 1;
-        player->cooldown = 25;
-        if(player->frame % 2 == 0) {
+        player->cooldown = secs_to_ticks(game, PLAYER_FIRE_DELAY);
+        if(tick_blink(game, player->frame, BLINK_TIME)) {
             player->rgba[3] = 150;
         } else {
             player->rgba[3] = 25;
@@ -155,8 +156,8 @@ void player_damage(Entity *player, WSL_App *game) {
             wsl_play_sound(game, mt_rand(SND_EXPLODE0, SND_EXPLODE4), CH_ANY);
         }
         player->flags |= EF_INV | EF_COOLDOWN;
-        player->frame = 120; //60fps, 120 is 2 seconds
-        player->cooldown = 25; // Can't shoot while "invulnerable"
+        player->frame = secs_to_ticks(game, PLAYER_HIT_INV);
+        player->cooldown = secs_to_ticks(game, PLAYER_FIRE_DELAY); // Can't shoot while "invulnerable"
         player->rgba[3] = 25; // Show the ship damage sprites 
     }
 }
@@ -169,6 +170,9 @@ void player_render(Entity *player, WSL_App *game) {
      */
     SDL_Rect damagerect = {0,0,0,0};
     SDL_Rect dmgquad = {0,0,0,0};
+    SDL_Color dmgcolor = {125,125,125,255};
+    float x, y;
+    double angle;
     switch(player->health) {
         case(4):
         case(3):
@@ -195,15 +199,14 @@ void player_render(Entity *player, WSL_App *game) {
     if(damagerect.x) {
         //render the damage rect under the player, so it's visable when the
         //player is transparent (after they take damage)
-        SDL_SetTextureColorMod(game->spritesheet->tex, 125,125,125);
-        SDL_SetTextureAlphaMod(game->spritesheet->tex, 255);
-        dmgquad.x = player->x;
-        dmgquad.y = player->y;
+        entity_lerp(player, game->alpha, &x, &y, &angle);
+        dmgquad.x = x;
+        dmgquad.y = y;
         dmgquad.w = damagerect.w * player->spritescale;
         dmgquad.h = damagerect.h * player->spritescale;
-        SDL_RenderCopyEx(game->renderer, game->spritesheet->tex,
-                &damagerect, &dmgquad,
-                player->angle, NULL, SDL_FLIP_NONE);
+        wsl_render_sprite(game->queue, player->layer, game->spritesheet,
+                SDL_BLENDMODE_BLEND, &damagerect, &dmgquad, angle,
+                dmgcolor);
     }
     entity_render(player, game);
 }
@@ -78,20 +78,22 @@ void update_projectile(Entity *proj, WSL_App *game) {
     }
 
     // Update the projectiles position
-    proj->x += proj->dx * proj->speed;
-    proj->y += proj->dy * proj->speed;
+    proj->x += proj->dx * proj->speed * game->tickscale;
+    proj->y += proj->dy * proj->speed * game->tickscale;
 }
 
 void update_projectile_flash(Entity *flash, WSL_App *game) {
+    int fade;
     flash->frame += 1;
-    flash->rgba[3] -= 25;
-    if(flash->frame >= 5) {
+    fade = 255 - (int)(25 * flash->frame * game->tickscale); // Same fade per second
+    flash->rgba[3] = fade > 0 ? fade : 0;
+    if(flash->frame >= secs_to_ticks(game, FLASH_GROW_TIME)) {
         flash->spriterect.x = 443;
         flash->spriterect.y = 182;
         flash->spriterect.w = 48;
         flash->spriterect.h = 46;
     }
-    if(flash->frame == 10) {
+    if(flash->frame >= secs_to_ticks(game, FLASH_LIFE)) {
         flash->flags &= ~EF_ALIVE;
     }
 }
@@ -107,7 +109,7 @@ void projectile_impact_death(Entity *proj, WSL_App *game) {
         flash->y = proj->y;
         flash->render = &entity_render;
         flash->update = &update_projectile_flash;
-        //flash->angle = 0.15 + (0.45*genrand_real1());
+        //flash->angle = 0.15 + (0.45*mt_real());
         flash->angle = 0.45;
         flash->spritescale = proj->spritescale * 0.6;
         wsl_add_entity(game, flash);
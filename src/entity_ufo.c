@@ -49,7 +49,7 @@ Entity* create_ufo(SDL_Rect spriterect) {
         ufo->ai->bzend.x = SCREEN_WIDTH + xoff;
     }
     //ufo->ai->bzend.x = ufo->ai->bzst.x ? (-10) : (SCREEN_WIDTH - 10);
-    //ufo->ai->bzend.y = (SCREEN_HEIGHT / 2)*(float)genrand_real1();
+    //ufo->ai->bzend.y = (SCREEN_HEIGHT / 2)*(float)mt_real();
     ufo->ai->bzend.y = 0; //Keeps the UFOs at the top of the screen
 
     //Interpolation point starts at 0
@@ -113,12 +113,9 @@ void ufo_update(Entity *ufo, WSL_App *game) {
 	//<SubTexture name="laserRed06.png" x="843" y="903" width="13" height="37"/>
     SDL_Rect projrect = {843,903,13,37};
     ufo->frame += 1; //Update the ufo's internal clock
-    if(ufo->frame % 3 == 0) {
-        // Every third frame rotate the ship a bit. 
-        ufo->angle += 15;
-    }
-    if(ufo->frame > 60) {
-        // 60 frames per second, so every second check the following:
+    ufo->angle += 5 * game->tickscale; // Spin the ship a bit
+    if(ufo->frame >= secs_to_ticks(game, UFO_THINK_TIME)) {
+        // Every second check the following:
         ufo->frame = 0;
         if(mt_chance(15)) ai->mvleft = !ai->mvleft; //15% chance to randomly change direction
         if((ufo->flags & EF_INV) == EF_INV) {
@@ -130,7 +127,7 @@ void ufo_update(Entity *ufo, WSL_App *game) {
     }
     //Flash sprite if invulnerable
     if((ufo->flags & EF_INV) == EF_INV) {
-        if(ufo->frame % 2 == 0) {
+        if(tick_blink(game, ufo->frame, BLINK_TIME)) {
             ufo->rgba[3] = 150;
         } else {
             ufo->rgba[3] = 25;
@@ -151,15 +148,15 @@ void ufo_update(Entity *ufo, WSL_App *game) {
      * start.x,ctB.y, and ctA.x,ctB.x makes a nice backwards "S" on the screen
      */
     if(ai->mvleft) {
-        ai->bzt -= ((float)ufo->speed / 1000);
+        ai->bzt -= ((float)ufo->speed / 1000) * game->tickscale;
     } else {
-        ai->bzt += ((float)ufo->speed / 1000);
+        ai->bzt += ((float)ufo->speed / 1000) * game->tickscale;
     }
     if(ai->bzt <= 0) {
         ai->bzt = 0;
         if(mt_bool()) {
             // Sometimes, change the end point when you reach the start
-            ai->bzend.y = (SCREEN_HEIGHT)*(float)genrand_real1();
+            ai->bzend.y = (SCREEN_HEIGHT)*(float)mt_real();
         }
         ai->mvleft = false;
     }
@@ -168,7 +165,7 @@ void ufo_update(Entity *ufo, WSL_App *game) {
         ai->mvleft = true;
         if(mt_bool()) {
             // Sometimes, change the end point when you reach the start
-            ai->bzst.y = (SCREEN_HEIGHT)*(float)genrand_real1();
+            ai->bzst.y = (SCREEN_HEIGHT)*(float)mt_real();
         }
     }
     newpos = get_vec2f_bezier_opt(ai->bzst, ai->bzmid, ai->bzend, ai->bzt);
@@ -185,7 +182,7 @@ void ufo_update(Entity *ufo, WSL_App *game) {
         proj->spritescale = ufo->spritescale;
         wsl_add_entity(game, proj); // Add projectile to list
         ufo->flags |= EF_COOLDOWN; // Turn on cooldown flag
-        ufo->cooldown = 60; // Start cooldown timer, entities should have a "firerate"
+        ufo->cooldown = secs_to_ticks(game, UFO_FIRE_DELAY); // Start cooldown timer, entities should have a "firerate"
         wsl_play_sound(game, SND_ALIEN_FIRE, CH_ALIEN);
     }
 }
@@ -0,0 +1,76 @@
+/*
+* Toolbox
+* Copyright (C) Zach Wilder 2022-2024
+*
+* This file is a part of Toolbox
+*
+* Toolbox is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Toolbox is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Toolbox.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <fasttrig.h>
+#include <math.h>
+#include <stdbool.h>
+
+#define TRIG_MASK (TRIG_TABLE_SIZE - 1)
+#define TRIG_QUARTER (TRIG_TABLE_SIZE / 4)
+
+/* One extra entry so interpolation never has to wrap the index */
+static float sin_table[TRIG_TABLE_SIZE + 1];
+static bool sin_table_ready = false;
+
+void fast_trig_init(void) {
+    /* Fill the sine table (in double, rounded once to float). Cheap, but
+     * should be called once at startup before any threads use the table. */
+    int i;
+    if(sin_table_ready) return;
+    for(i = 0; i <= TRIG_TABLE_SIZE; i++) {
+        sin_table[i] = (float)sin((2.0 * M_PI * i) / TRIG_TABLE_SIZE);
+    }
+    sin_table_ready = true;
+}
+
+void fast_sincosf(float angle, float *s, float *c) {
+    /* sin/cos of any angle in radians, interpolated from the table. The index
+     * math is done in double, in float the fraction loses bits as the angle
+     * grows. */
+    const double to_index = TRIG_TABLE_SIZE / (2.0 * M_PI);
+    double pos = angle * to_index;
+    int64_t whole = (int64_t)pos;
+    float frac = 0;
+    int i = 0, j = 0;
+    if(!sin_table_ready) fast_trig_init();
+    if(pos < whole) whole--; // floor() without the libm call
+    frac = (float)(pos - whole);
+    i = (int)(whole & TRIG_MASK);
+    j = (i + TRIG_QUARTER) & TRIG_MASK;
+    *s = sin_table[i] + (sin_table[i + 1] - sin_table[i]) * frac;
+    *c = sin_table[j] + (sin_table[j + 1] - sin_table[j]) * frac;
+}
+
+void fast_sincos_bits(uint32_t bits, float *s, float *c) {
+    /* sin/cos of a uniformly random direction, picked by the top bits of a
+     * random number (the low bits aren't needed, no multiply, no floor) */
+    uint32_t i = bits >> (32 - TRIG_TABLE_BITS);
+    if(!sin_table_ready) fast_trig_init();
+    *s = sin_table[i];
+    *c = sin_table[(i + TRIG_QUARTER) & TRIG_MASK];
+}
+
+void fast_sincos_bulk(const float *angles, float *s, float *c, int n) {
+    /* fast_sincosf over an array, for emitters that build a batch of
+     * directions at once */
+    int i;
+    for(i = 0; i < n; i++) {
+        fast_sincosf(angles[i], &s[i], &c[i]);
+    }
+}
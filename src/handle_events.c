@@ -45,6 +45,11 @@ void handle_events(WSL_App *game) {
 }
 
 void handle_keydown(SDL_KeyboardEvent *event, WSL_App *game) {
+    if((event->keysym.sym == SDLK_F3) && (event->repeat == 0)) {
+        // Toggle the stats overlay, in any state
+        game->stats.show = !game->stats.show;
+        return;
+    }
     switch(game->state) {
         case GS_MENU:
             handle_keydown_menu(event,game);
@@ -69,7 +74,7 @@ void handle_keydown_menu(SDL_KeyboardEvent *event, WSL_App *game) {
                 y = mt_rand(0,SCREEN_HEIGHT);
                 spawn_random_color_explosion(x,y, game);
             }
-            //spawn_bliptxt(10,10,game,"TEST TEXT!",60,255,0,0,250);
+            //spawn_bliptxt(10,10,game,"TEST TEXT!",1.0,255,0,0,250);
             break;
         case SDLK_n:
             game->state = GS_NEW;
@@ -0,0 +1,82 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+uint64_t headless_run(WSL_App *game, long ticks) {
+    /*
+     * Start a new game and run ticks updates back to back, as fast as they
+     * go, through the same update() the game loop calls. Nothing is drawn
+     * and no events are polled, so the keyboard comes from a replay, or the
+     * game plays itself hands off. Stops early at the end of a replay.
+     * Returns the nanoseconds it took.
+     */
+    uint64_t start;
+    long i;
+    game->stats = (WSL_Stats){0};
+    game->state = GS_NEW;
+    start = wsl_clock_now();
+    for(i = 0; (i < ticks) && game->running && !replay_done(game->replay);
+            i++) {
+        update(game);
+    }
+    return wsl_clock_now() - start;
+}
+
+void headless_report(WSL_App *game, uint64_t elapsed) {
+    /* Ticks per second, and where the time in update() went */
+    static const char *phases[UP_MAX] = {
+        "entities", "particles", "cleanup", "snapshot", "autopilot"
+    };
+    WSL_Stats *stats = &game->stats;
+    Entity *entity = NULL;
+    double secs = (double)elapsed / NS_PER_SEC;
+    double rate = secs > 0 ? stats->updates / secs : 0;
+    char range[32];
+    int i, alive = 0;
+
+    for(entity = game->entities; entity; entity = entity->next) {
+        alive += 1;
+    }
+    printf("%llu ticks in %.3f s, %.0f ticks/s (%.1fx real time at %d Hz)\n",
+            (unsigned long long)stats->updates, secs, rate,
+            rate / game->tickrate, game->tickrate);
+    for(i = 0; i < UP_MAX; i++) {
+        printf("  %-10s %10.2f ms %10.2f us/tick %6.1f%%\n", phases[i],
+                stats->phase[i] / (double)NS_PER_MS,
+                stats->updates ? stats->phase[i] / 1000.0 / stats->updates : 0,
+                elapsed ? 100.0 * stats->phase[i] / elapsed : 0);
+    }
+    printf("Score %d, %d entities alive, %d at most\n", game->score, alive,
+            stats->peakentities);
+    // Updates by how long they took, skipping the empty buckets
+    for(i = 0; i < TICK_HIST_BUCKETS; i++) {
+        if(!stats->tickhist[i]) continue;
+        if(i == TICK_HIST_BUCKETS - 1) {
+            snprintf(range, sizeof(range), "%d+ us", 1 << i);
+        } else {
+            snprintf(range, sizeof(range), "%d-%d us", i ? 1 << i : 0, 2 << i);
+        }
+        printf("  %-16s %10llu ticks %6.2f%%\n", range,
+                (unsigned long long)stats->tickhist[i],
+                100.0 * stats->tickhist[i] / stats->updates);
+    }
+    autopilot_report(game->autopilot, game);
+}
@@ -19,31 +19,157 @@
 */
 
 #include <spaceshooter.h>
-#include <sys/time.h>
 
-long current_ms(void) {
-    // Helper function to return the current time in ms
-    struct timeval tp;
-    gettimeofday(&tp, NULL);
-    return ((tp.tv_sec * 1000) + (tp.tv_usec / 1000));
+static int main_sims(int count, int threads, unsigned long seed,
+        int tickrate, long ticks, bool autopilot) {
+    /* --sims: count games side by side on a pool, no SDL_App at all */
+    WSL_App **sims = calloc(count, sizeof(WSL_App*));
+    WSL_Pool *pool = NULL;
+    uint64_t elapsed;
+    int i;
+    if(!sims) return 1;
+    fast_trig_init(); // Before any thread wants the table
+    for(i = 0; i < count; i++) {
+        sims[i] = sim_create(seed + i);
+        if(!sims[i]) {
+            printf("Unable to create sim %d!\n", i);
+            count = i;
+            break;
+        }
+        set_tick_rate(sims[i], tickrate);
+        if(autopilot) sims[i]->autopilot = autopilot_create();
+    }
+    if(ticks <= 0) {
+        ticks = (long)HEADLESS_SECONDS * (count ? sims[0]->tickrate : tickrate);
+    }
+    pool = wsl_pool_create(threads);
+    printf("Sims, seeds %lu-%lu, %ld ticks each at %d Hz\n", seed,
+            seed + count - 1, ticks, count ? sims[0]->tickrate : tickrate);
+    elapsed = sim_run(pool, sims, count, ticks);
+    sim_report(sims, count, wsl_pool_threads(pool), elapsed);
+    wsl_pool_destroy(pool);
+    for(i = 0; i < count; i++) {
+        sim_destroy(sims[i]);
+    }
+    free(sims);
+    return 0;
 }
 
 int main(int argc, char **argv) {
-    long lag = 0, current = 0, elapsed = 0;
-    long prev = current_ms();
-    long msperframe = 16; // 16ms = ~60fps, 33ms = ~30fps
-    WSL_App *game = wsl_init_sdl(); // Start SDL, load resources
+    uint64_t lag = 0, current = 0, elapsed = 0, prev = 0;
+    uint64_t nsperframe = 0; // Time per update, from the tick rate
+    uint64_t frametime = NS_PER_SEC / 60; // Drawn frames, paced
+    int maxsteps = MAX_CATCHUP_STEPS;
+    int tickrate = BASE_TICK_RATE;
+    long ticks = 0;
+    unsigned long seed = time(NULL);
+    char *record = NULL, *replay = NULL;
+    bool autopilot = false;
+    int backend = RB_SDL;
+    int sims = 0, threads = 0;
+    int i;
+    WSL_App *game = NULL;
+
+    // --cpu draws on the CPU instead of through an SDL_Renderer
+    // --fps N draws at most N frames a second, 0 as fast as it can
+    // --catchup N runs at most N updates a frame, 0 for no limit
+    // --tickrate N runs N updates a second, the game plays the same at any
+    // --headless runs the simulation alone, no window or sound, flat out
+    // --ticks N is how many updates --headless runs
+    // --seed N seeds the random numbers, for a game that plays the same again
+    // --record FILE saves the next game's seed and keyboard to FILE
+    // --replay FILE plays a recorded game back, in a window or --headless
+    // --autopilot plays by itself, one game after another (for soak runs)
+    // --sims K runs K games at once, headless, seeded seed, seed + 1...
+    // --threads N shares them out over N threads, 0 (default) one per CPU
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--cpu") == 0) {
+            backend = RB_CPU;
+        } else if((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc)) {
+            i++;
+            frametime = atoi(argv[i]) > 0 ? NS_PER_SEC / atoi(argv[i]) : 0;
+        } else if((strcmp(argv[i], "--catchup") == 0) && (i + 1 < argc)) {
+            i++;
+            maxsteps = atoi(argv[i]) > 0 ? atoi(argv[i]) : 0;
+        } else if((strcmp(argv[i], "--tickrate") == 0) && (i + 1 < argc)) {
+            i++;
+            tickrate = atoi(argv[i]);
+        } else if(strcmp(argv[i], "--headless") == 0) {
+            backend = RB_HEADLESS;
+        } else if((strcmp(argv[i], "--ticks") == 0) && (i + 1 < argc)) {
+            i++;
+            ticks = atol(argv[i]);
+        } else if((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) {
+            i++;
+            seed = strtoul(argv[i], NULL, 10);
+        } else if((strcmp(argv[i], "--record") == 0) && (i + 1 < argc)) {
+            record = argv[++i];
+        } else if((strcmp(argv[i], "--replay") == 0) && (i + 1 < argc)) {
+            replay = argv[++i];
+        } else if(strcmp(argv[i], "--autopilot") == 0) {
+            autopilot = true;
+        } else if((strcmp(argv[i], "--sims") == 0) && (i + 1 < argc)) {
+            i++;
+            sims = atoi(argv[i]);
+        } else if((strcmp(argv[i], "--threads") == 0) && (i + 1 < argc)) {
+            i++;
+            threads = atoi(argv[i]);
+        }
+    }
+    if(sims > 0) {
+        return main_sims(sims, threads, seed, tickrate, ticks, autopilot);
+    }
+    game = wsl_init_sdl(backend); // Start SDL, load resources
 
-    init_genrand(time(NULL)); // Seed the pnrg
+    mt_seed(seed); // Seed the pnrg
+    fast_trig_init(); // Build the sin/cos table
 
     if(!game) {
         printf("Failed to create WSL_App!\n");
         return 1;
     }
+    if(replay) {
+        // The recording's seed and tick rate, straight into a new game
+        game->replay = replay_open(replay);
+        if(!game->replay) {
+            wsl_cleanup_sdl(game);
+            return 1;
+        }
+        seed = game->replay->seed;
+        tickrate = game->replay->tickrate;
+        game->state = GS_NEW;
+    }
+    game->seed = seed;
+    set_tick_rate(game, tickrate);
+    nsperframe = NS_PER_SEC / game->tickrate;
+    game->asteroidspawn = secs_to_ticks(game, ASTEROID_SPAWN_FIRST);
+    if(record && !replay) {
+        game->replay = replay_record(record, seed, game->tickrate);
+    }
+    if(autopilot && !replay) {
+        // A replay has the keyboard already
+        game->autopilot = autopilot_create();
+    }
 
-    /* Basic game loop, straight outta Game Programming Patterns */
+    if(game->backend == RB_HEADLESS) {
+        if((ticks <= 0) && game->replay && !game->replay->recording) {
+            ticks = game->replay->ticks;
+        }
+        if(ticks <= 0) ticks = (long)HEADLESS_SECONDS * game->tickrate;
+        printf("Headless, seed %lu, %ld ticks at %d Hz\n", seed, ticks,
+                game->tickrate);
+        headless_report(game, headless_run(game, ticks));
+        wsl_cleanup_sdl(game);
+        return 0;
+    }
+
+    /* Basic game loop, straight outta Game Programming Patterns. Without
+     * vsync holding it back, the pacing at the end of each frame sleeps off
+     * the rest of the frame instead of spinning round to draw another. */
+    wsl_clock_init(&game->clock, frametime);
+    prev = wsl_clock_now();
     while(game->running) {
-        current = current_ms();
+        current = wsl_clock_now();
         elapsed = current - prev;
         prev = current;
         lag += elapsed;
@@ -51,16 +177,17 @@ int main(int argc, char **argv) {
         //Handle events
         handle_events(game);
 
-        //Update
-        while(lag >= msperframe) {
-            lag -= msperframe;
-            update(game);
-        }
+        //Update, catching up on as much of the lag as it's allowed to
+        update_steps(game, &lag, nsperframe, maxsteps);
 
-        //Draw
+        //Draw, blended between the last two updates by how far along the
+        //next one is
+        game->alpha = (float)((double)lag / nsperframe);
         draw(game);
+        wsl_clock_pace(&game->clock);
     }
 
+    autopilot_report(game->autopilot, game);
     wsl_cleanup_sdl(game);
     return 0;
 }
@@ -50,12 +50,20 @@
 #define UPPER_MASK 0x80000000UL /* most significant w-r bits */
 #define LOWER_MASK 0x7fffffffUL /* least significant r bits */
 
-static unsigned long mt[N]; /* the array for the state vector  */
-static int mti=N+1; /* mti==N+1 means mt[N] is not initialized */
+/* Default state used by the non-reentrant functions below */
+static MT19937 mt_default = { {0}, N+1 }; /* mti==N+1 means mt[N] is not initialized */
 
 /* initializes mt[N] with a seed */
 void init_genrand(unsigned long s)
 {
+    init_genrand_r(&mt_default, s);
+}
+
+/* initializes a caller owned state with a seed */
+void init_genrand_r(MT19937 *state, unsigned long s)
+{
+    unsigned long *mt = state->mt;
+    int mti;
     mt[0]= s & 0xffffffffUL;
     for (mti=1; mti<N; mti++) {
         mt[mti] = 
@@ -67,6 +75,7 @@ void init_genrand(unsigned long s)
         mt[mti] &= 0xffffffffUL;
         /* for >32 bit machines */
     }
+    state->mti = mti;
 }
 
 /* initialize by an array with array-length */
@@ -75,6 +84,7 @@ void init_genrand(unsigned long s)
 /* slight change for C++, 2004/2/26 */
 void init_by_array(unsigned long init_key[], int key_length)
 {
+    unsigned long *mt = mt_default.mt;
     int i, j, k;
     init_genrand(19650218UL);
     i=1; j=0;
@@ -101,15 +111,23 @@ void init_by_array(unsigned long init_key[], int key_length)
 /* generates a random number on [0,0xffffffff]-interval */
 unsigned long genrand_int32(void)
 {
+    return genrand_int32_r(&mt_default);
+}
+
+/* generates a random number on [0,0xffffffff]-interval from a caller owned
+ * state */
+unsigned long genrand_int32_r(MT19937 *state)
+{
+    unsigned long *mt = state->mt;
     unsigned long y;
     static unsigned long mag01[2]={0x0UL, MATRIX_A};
     /* mag01[x] = x * MATRIX_A  for x=0,1 */
 
-    if (mti >= N) { /* generate N words at one time */
+    if (state->mti >= N) { /* generate N words at one time */
         int kk;
 
-        if (mti == N+1)   /* if init_genrand() has not been called, */
-            init_genrand(5489UL); /* a default initial seed is used */
+        if (state->mti == N+1)   /* if init_genrand() has not been called, */
+            init_genrand_r(state, 5489UL); /* a default initial seed is used */
 
         for (kk=0;kk<N-M;kk++) {
             y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);
@@ -122,10 +140,10 @@ unsigned long genrand_int32(void)
         y = (mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK);
         mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1UL];
 
-        mti = 0;
+        state->mti = 0;
     }
   
-    y = mt[mti++];
+    y = mt[state->mti++];
 
     /* Tempering */
     y ^= (y >> 11);
@@ -170,45 +188,3 @@ double genrand_res53(void)
     return(a*67108864.0+b)*(1.0/9007199254740992.0); 
 } 
 /* These real versions are due to Isaku Wada, 2002/01/09 added */
-
-/*
- * Functions below added by Zach Wilder, 2022, with the same conditions as
- * above.
- *
- * int mt_rand(int min, int max); 
- * bool mt_bool(void); 
- * bool mt_chance(int chance);
- *
- */
-int mt_rand_lim(int limit) {
-    /* So, the random number functions below with the % operator will introduce
-     * skew. Like trying to split ten candies with 3 kids - and not being able
-     * to cut anything into smaller pieces. A single piece will be left over...
-     * This takes the candy, divides it by 3, and if the result is greater than
-     * 3 puts it back into the bucket. */
-    int divisor = RAND_MAX/(limit + 1);
-    int retval;
-    do {
-        retval = genrand_int32() / divisor;
-    } while (retval > limit);
-
-    return retval;
-}
-
-int mt_rand(int min, int max) {
-    return (mt_rand_lim(max - min) + min);
-}
-
-bool mt_bool() {
-    int result = mt_rand(1,10);
-    return (result <= 5);
-}
-
-bool mt_chance(int chance) {
-    /* Idea: I want a 1/3 chance of something happening, so I call
-     * mt_chance(33). It gets a random number between 1 and 100, and then
-     * returns true if the random number is less than the 33. */
-    int result = mt_rand(1,100);
-    return(result <= chance);
-}
-
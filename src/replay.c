@@ -0,0 +1,285 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+/*****
+ * Reading and writing the file
+ *****/
+static void replay_put_le(uint8_t *buf, uint64_t value, int bytes) {
+    int i;
+    for(i = 0; i < bytes; i++) {
+        buf[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static uint64_t replay_get_le(const uint8_t *buf, int bytes) {
+    uint64_t value = 0;
+    int i;
+    for(i = 0; i < bytes; i++) {
+        value |= (uint64_t)buf[i] << (8 * i);
+    }
+    return value;
+}
+
+static void replay_put_varint(FILE *file, uint32_t value) {
+    /* 7 bits a byte, high bit set on all but the last */
+    while(value >= 0x80) {
+        fputc((value & 0x7F) | 0x80, file);
+        value >>= 7;
+    }
+    fputc(value, file);
+}
+
+static bool replay_get_varint(Replay *replay, uint32_t *value) {
+    int shift = 0;
+    uint8_t byte;
+    *value = 0;
+    do {
+        if((replay->pos >= replay->size) || (shift > 28)) return false;
+        byte = replay->data[replay->pos++];
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while(byte & 0x80);
+    return true;
+}
+
+static void replay_write_header(Replay *replay) {
+    uint8_t header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, 4);
+    header[4] = REPLAY_VERSION;
+    replay_put_le(header + 5, replay->tickrate, 2);
+    replay_put_le(header + 7, replay->seed, 8);
+    replay_put_le(header + 15, replay->ticks, 4);
+    replay_put_le(header + 19, replay->hash, 8);
+    fseek(replay->file, 0, SEEK_SET);
+    fwrite(header, 1, REPLAY_HEADER_SIZE, replay->file);
+    fseek(replay->file, 0, SEEK_END);
+}
+
+static void replay_next_change(Replay *replay) {
+    /* When the next record is due, or never if that was the last one */
+    uint32_t delta;
+    if(replay_get_varint(replay, &delta)) {
+        replay->next = replay->last + delta;
+    } else {
+        replay->next = UINT32_MAX;
+    }
+}
+
+/*****
+ * Replay
+ *****/
+Replay* replay_record(const char *path, uint64_t seed, int tickrate) {
+    /* Start a recording at path, written out as the next game is played */
+    Replay *replay = calloc(1, sizeof(Replay));
+    if(!replay) return NULL;
+    replay->file = fopen(path, "wb");
+    if(!replay->file) {
+        printf("Unable to open %s to record to!\n", path);
+        free(replay);
+        return NULL;
+    }
+    replay->recording = true;
+    replay->seed = seed;
+    replay->tickrate = tickrate;
+    replay_write_header(replay); // Ticks and hash filled in at the end
+    return replay;
+}
+
+Replay* replay_open(const char *path) {
+    /* Read in a recording to play back */
+    Replay *replay = NULL;
+    FILE *file = fopen(path, "rb");
+    long size;
+    if(!file) {
+        printf("Unable to open replay %s!\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    replay = calloc(1, sizeof(Replay));
+    if(replay && (size >= REPLAY_HEADER_SIZE)) {
+        replay->data = malloc(size);
+        replay->size = size;
+    }
+    if(!replay || !replay->data ||
+            (fread(replay->data, 1, size, file) != (size_t)size) ||
+            (memcmp(replay->data, REPLAY_MAGIC, 4) != 0) ||
+            (replay->data[4] != REPLAY_VERSION)) {
+        printf("%s isn't a replay this version can play!\n", path);
+        if(replay) free(replay->data);
+        free(replay);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    replay->tickrate = replay_get_le(replay->data + 5, 2);
+    replay->seed = replay_get_le(replay->data + 7, 8);
+    replay->ticks = replay_get_le(replay->data + 15, 4);
+    replay->hash = replay_get_le(replay->data + 19, 8);
+    replay->pos = REPLAY_HEADER_SIZE;
+    return replay;
+}
+
+static void replay_start(Replay *replay, WSL_App *game) {
+    /* A new game is starting, everything random in it comes from the seed */
+    mt_seed(replay->seed);
+    replay->started = true;
+    replay->tick = 0;
+    replay->last = 0;
+    memset(replay->keys, 0, sizeof(replay->keys));
+    if(!replay->recording) replay_next_change(replay);
+}
+
+static void replay_finish(Replay *replay, WSL_App *game) {
+    /* Fill in the header, the recording's done */
+    if(replay->done) return;
+    replay->done = true;
+    replay->ticks = replay->tick;
+    replay->hash = replay_state_hash(game);
+    replay_write_header(replay);
+    fclose(replay->file);
+    replay->file = NULL;
+    printf("Recorded %u ticks\n", replay->ticks);
+}
+
+static void replay_verdict(Replay *replay, WSL_App *game) {
+    /* Played back to the end, see if it came out the way it was recorded */
+    replay->done = true;
+    memset(game->keyboard, 0, sizeof(game->keyboard));
+    printf("Replay finished after %u ticks, %s\n", replay->tick,
+            (replay_state_hash(game) == replay->hash) ? "same game" :
+            "DIFFERENT game");
+}
+
+static void replay_record_tick(Replay *replay, WSL_App *game) {
+    /* Write down the scancodes that changed since the last tick, if any */
+    int changed[MAX_KEYBOARD_KEYS];
+    int i, count = 0;
+    for(i = 0; i < MAX_KEYBOARD_KEYS; i++) {
+        if(game->keyboard[i] != replay->keys[i]) {
+            changed[count++] = i;
+            replay->keys[i] = game->keyboard[i];
+        }
+    }
+    if(count) {
+        replay_put_varint(replay->file, replay->tick - replay->last);
+        replay_put_varint(replay->file, count);
+        for(i = 0; i < count; i++) {
+            replay_put_varint(replay->file, changed[i]);
+        }
+        replay->last = replay->tick;
+    }
+}
+
+static void replay_play_tick(Replay *replay, WSL_App *game) {
+    /* Flip the scancodes that change this tick, and hand the whole keyboard
+     * over to the game, whatever's being pressed for real */
+    uint32_t i, count, scancode;
+    if(replay->tick == replay->next) {
+        if(replay_get_varint(replay, &count)) {
+            for(i = 0; i < count; i++) {
+                if(replay_get_varint(replay, &scancode) &&
+                        (scancode < MAX_KEYBOARD_KEYS)) {
+                    replay->keys[scancode] = !replay->keys[scancode];
+                }
+            }
+        }
+        replay->last = replay->tick;
+        replay_next_change(replay);
+    }
+    memcpy(game->keyboard, replay->keys, sizeof(replay->keys));
+}
+
+void replay_update(Replay *replay, WSL_App *game) {
+    /*
+     * Called at the start of every update. Starts with the next new game,
+     * then records or plays back the keyboard for this tick. A recording
+     * stops when the game's over and it's back to the menu, a play back
+     * when it runs out of ticks, and then the player has the keyboard back.
+     */
+    if(!replay || replay->done) return;
+    if(!replay->started) {
+        if(game->state != GS_NEW) return;
+        replay_start(replay, game);
+    }
+    if(replay->recording) {
+        if((game->state == GS_MENU) || (game->state == GS_SCORES)) {
+            replay_finish(replay, game);
+            return;
+        }
+        replay_record_tick(replay, game);
+    } else if(replay_done(replay)) {
+        replay_verdict(replay, game);
+        return;
+    } else {
+        replay_play_tick(replay, game);
+    }
+    replay->tick += 1;
+}
+
+bool replay_done(Replay *replay) {
+    /* Played back every tick there is (recordings are done when they say) */
+    if(!replay) return false;
+    if(replay->recording) return replay->done;
+    return replay->done || (replay->started && (replay->tick >= replay->ticks));
+}
+
+void replay_close(Replay *replay, WSL_App *game) {
+    /* Finish off a recording still going (or check a finished play back),
+     * and free it */
+    if(!replay) return;
+    if(replay->recording && replay->started) replay_finish(replay, game);
+    if(!replay->recording && !replay->done && replay_done(replay)) {
+        replay_verdict(replay, game);
+    }
+    if(replay->file) fclose(replay->file);
+    free(replay->data);
+    free(replay);
+}
+
+uint64_t replay_state_hash(WSL_App *game) {
+    /*
+     * FNV-1a over the score and every entity's position, flags and health.
+     * Any difference in how the game played out shows up in it.
+     */
+    uint64_t h = 14695981039346656037ULL;
+    Entity *e = NULL;
+    int32_t values[5];
+    size_t i;
+    const uint8_t *bytes = (const uint8_t*)&game->score;
+    for(i = 0; i < sizeof(game->score); i++) {
+        h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+    for(e = game->entities; e; e = e->next) {
+        memcpy(&values[0], &e->x, sizeof(float));
+        memcpy(&values[1], &e->y, sizeof(float));
+        values[2] = e->flags;
+        values[3] = e->health;
+        values[4] = e->frame;
+        bytes = (const uint8_t*)values;
+        for(i = 0; i < sizeof(values); i++) {
+            h = (h ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
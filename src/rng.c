@@ -0,0 +1,478 @@
+/*
+* Toolbox
+* Copyright (C) Zach Wilder 2022-2024
+*
+* This file is a part of Toolbox
+*
+* Toolbox is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Toolbox is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Toolbox.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <rng.h>
+#include <string.h>
+
+/*******
+ * RNG wraps whichever generator was chosen at compile time (see rng.h) behind
+ * one interface, and builds the bounded integer/boolean/percent helpers the
+ * game actually uses on top of it. The mt_* names are kept from when these
+ * helpers lived at the bottom of mt19937.c.
+ *******/
+
+static RNGContext rng_default = { .rng = { .nbits = 0 } };
+
+/* Context the calling thread's mt_* functions use, see rng_use_context() */
+static _Thread_local RNGContext *rng_context = NULL;
+
+/* Per thread stream that stands in for the global RNG, see rng_use_stream() */
+static _Thread_local RNG rng_stream;
+static _Thread_local uint64_t rng_stream_seed;
+static _Thread_local bool rng_stream_active = false;
+static _Thread_local bool rng_stream_seeded = false;
+
+#if defined(__GNUC__)
+/* GCC/clang vector extensions: one variable holds a value for every lane, and
+ * compiles down to SSE2/AVX2/NEON without any intrinsics */
+#define RNG_BLOCK_SIMD
+typedef uint32_t u32xL __attribute__((vector_size(RNG_BLOCK_LANES * 4)));
+typedef int32_t i32xL __attribute__((vector_size(RNG_BLOCK_LANES * 4)));
+typedef float f32xL __attribute__((vector_size(RNG_BLOCK_LANES * 4)));
+#endif
+
+static uint64_t splitmix64(uint64_t *x) {
+    /* Used to expand a single seed into the xoshiro/pcg/block state, as
+     * recommended by the xoshiro authors */
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+#if defined(RNG_XOSHIRO)
+static inline uint64_t rotl64(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+#endif
+
+const char* rng_name(void) {
+#if defined(RNG_XOSHIRO)
+    return "xoshiro256**";
+#elif defined(RNG_PCG32)
+    return "pcg32";
+#else
+    return "mt19937";
+#endif
+}
+
+void rng_seed(RNG *rng, uint64_t seed) {
+#if defined(RNG_XOSHIRO)
+    uint64_t sm = seed;
+    rng->s[0] = splitmix64(&sm);
+    rng->s[1] = splitmix64(&sm);
+    rng->s[2] = splitmix64(&sm);
+    rng->s[3] = splitmix64(&sm);
+#elif defined(RNG_PCG32)
+    uint64_t sm = seed;
+    rng->state = 0;
+    rng->inc = (splitmix64(&sm) << 1) | 1; // Stream selector, must be odd
+    rng_next(rng);
+    rng->state += splitmix64(&sm);
+    rng_next(rng);
+#else
+    init_genrand_r(&rng->mt, (unsigned long)seed);
+#endif
+    rng->bits = 0;
+    rng->nbits = 0;
+}
+
+uint32_t rng_next(RNG *rng) {
+    /* Returns a full 32 bit random number on [0,0xffffffff] */
+#if defined(RNG_XOSHIRO)
+    const uint64_t result = rotl64(rng->s[1] * 5, 7) * 9;
+    const uint64_t t = rng->s[1] << 17;
+    rng->s[2] ^= rng->s[0];
+    rng->s[3] ^= rng->s[1];
+    rng->s[1] ^= rng->s[2];
+    rng->s[0] ^= rng->s[3];
+    rng->s[2] ^= t;
+    rng->s[3] = rotl64(rng->s[3], 45);
+    return (uint32_t)(result >> 32); // High bits are the strongest
+#elif defined(RNG_PCG32)
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31));
+#else
+    return (uint32_t)genrand_int32_r(&rng->mt);
+#endif
+}
+
+uint32_t rng_bounded(RNG *rng, uint32_t range) {
+    /*
+     * Returns a number on [0,range) without modulo skew, using Lemire's
+     * multiply-shift method: the 32 bit draw times the range is a 64 bit
+     * number whose high half is the result. Only the low half needs checking
+     * for the few values that would skew the result, so the rejection loop
+     * almost never runs (worst case is just under half, for huge ranges),
+     * and the expensive modulo only happens on the rare slow path.
+     */
+    uint64_t m = (uint64_t)rng_next(rng) * range;
+    uint32_t low = (uint32_t)m;
+    uint32_t threshold = 0;
+    if(low < range) {
+        threshold = -range % range; // (2^32 - range) % range
+        while(low < threshold) {
+            m = (uint64_t)rng_next(rng) * range;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+uint32_t rng_bits(RNG *rng, int n) {
+    /*
+     * Hands out n (1-32) random bits from a reservoir, only drawing a new
+     * 32 bit number when the reservoir runs dry. A coin flip costs one bit
+     * instead of a whole draw.
+     */
+    uint32_t result = 0;
+    if(n >= 32) return rng_next(rng);
+    if(rng->nbits < n) {
+        rng->bits = rng_next(rng);
+        rng->nbits = 32;
+    }
+    result = rng->bits & ((1u << n) - 1);
+    rng->bits >>= n;
+    rng->nbits -= n;
+    return result;
+}
+
+double rng_real1(RNG *rng) {
+    /* Random number on [0,1]-real-interval, same as genrand_real1() */
+    return rng_next(rng)*(1.0/4294967295.0);
+}
+
+void rng_pack(const RNG *rng, uint32_t *words) {
+    /* The state in RNG_PACKED_WORDS words, with nothing but state in them
+     * (MT19937 keeps 32 bit words in unsigned longs, half of it padding) */
+    int i = 0, n = 0;
+#if defined(RNG_XOSHIRO)
+    for(i = 0; i < 4; i++) {
+        words[n++] = (uint32_t)rng->s[i];
+        words[n++] = (uint32_t)(rng->s[i] >> 32);
+    }
+#elif defined(RNG_PCG32)
+    const uint64_t v[2] = {rng->state, rng->inc};
+    for(i = 0; i < 2; i++) {
+        words[n++] = (uint32_t)v[i];
+        words[n++] = (uint32_t)(v[i] >> 32);
+    }
+#else
+    for(i = 0; i < 624; i++) {
+        words[n++] = (uint32_t)rng->mt.mt[i];
+    }
+    words[n++] = (uint32_t)rng->mt.mti;
+#endif
+    words[n++] = rng->bits;
+    words[n++] = (uint32_t)rng->nbits;
+}
+
+void rng_unpack(RNG *rng, const uint32_t *words) {
+    /* Back the way rng_pack() found it */
+    int i = 0, n = 0;
+#if defined(RNG_XOSHIRO)
+    for(i = 0; i < 4; i++) {
+        rng->s[i] = words[n] | ((uint64_t)words[n + 1] << 32);
+        n += 2;
+    }
+#elif defined(RNG_PCG32)
+    uint64_t v[2];
+    for(i = 0; i < 2; i++) {
+        v[i] = words[n] | ((uint64_t)words[n + 1] << 32);
+        n += 2;
+    }
+    rng->state = v[0];
+    rng->inc = v[1];
+#else
+    for(i = 0; i < 624; i++) {
+        rng->mt.mt[i] = words[n++];
+    }
+    rng->mt.mti = (int)words[n++];
+#endif
+    rng->bits = words[n++];
+    rng->nbits = (int)words[n++];
+}
+
+RNG* rng_global(void) {
+    /* The RNG the mt_* functions use, seeded with the MT19937 default seed if
+     * nobody called mt_seed() (matches the old genrand_int32() behavior).
+     * A thread that switched to its own stream gets that instead, and one
+     * running a game with an RNGContext of its own gets the context's. */
+    RNGContext *ctx = NULL;
+    if(rng_stream_active) {
+        if(!rng_stream_seeded) {
+            // Only pay for seeding if the stream actually gets used
+            rng_seed(&rng_stream, rng_stream_seed);
+            rng_stream_seeded = true;
+        }
+        return &rng_stream;
+    }
+    ctx = rng_context ? rng_context : &rng_default;
+    if(!ctx->seeded) {
+        rng_seed(&ctx->rng, 5489UL);
+        ctx->seeded = true;
+    }
+    return &ctx->rng;
+}
+
+void rng_use_stream(uint64_t seed) {
+    /*
+     * Point rng_global() (and so the mt_* functions) at a private stream for
+     * the calling thread until rng_use_global(). Worker threads use this so
+     * each chunk of work draws the same numbers no matter which thread runs
+     * it, and without racing on the global RNG.
+     */
+    rng_stream_seed = seed;
+    rng_stream_active = true;
+    rng_stream_seeded = false;
+}
+
+void rng_use_global(void) {
+    rng_stream_active = false;
+}
+
+RNGContext* rng_use_context(RNGContext *ctx) {
+    /*
+     * Point the calling thread's mt_* and mt_fast_* functions (and mt_seed)
+     * at ctx, NULL for the process wide one. Returns the context it was
+     * using, to switch back to. Each game instance can have a context of its
+     * own, so games on different threads never share a generator.
+     */
+    RNGContext *prev = rng_context;
+    rng_context = ctx;
+    return prev;
+}
+
+RNGContext* rng_current_context(void) {
+    /* The context the calling thread is drawing from */
+    return rng_context ? rng_context : &rng_default;
+}
+
+/*****
+ * RNGBlock
+ *
+ * Every lane runs its own xoshiro128** (Blackman/Vigna), the 32 bit sibling of
+ * xoshiro256**. The step only needs shifts, xors and adds (the *5 and *9 are
+ * done as shift+add), so it vectorizes on plain SSE2. Values are written lane
+ * interleaved: u32[i] comes from lane i % RNG_BLOCK_LANES.
+ *****/
+void rng_block_seed(RNGBlock *blk, uint64_t seed) {
+    int i, lane;
+    uint64_t sm = seed;
+    for(lane = 0; lane < RNG_BLOCK_LANES; lane++) {
+        for(i = 0; i < 4; i++) {
+            blk->s[i][lane] = (uint32_t)splitmix64(&sm);
+        }
+        if(!(blk->s[0][lane] | blk->s[1][lane] | 
+                    blk->s[2][lane] | blk->s[3][lane])) {
+            blk->s[0][lane] = 1; // All zero state never leaves zero
+        }
+    }
+    blk->u32_cursor = RNG_BLOCK_SIZE; // Empty, first use refills
+    blk->real_cursor = RNG_BLOCK_SIZE;
+    blk->bits = 0;
+    blk->nbits = 0;
+}
+
+#ifdef RNG_BLOCK_SIMD
+static inline void rng_block_step(u32xL *s0, u32xL *s1, u32xL *s2, 
+        u32xL *s3, u32xL *result) {
+    u32xL r = *s1 + (*s1 << 2); // s1 * 5
+    u32xL t = *s1 << 9;
+    r = (r << 7) | (r >> 25); // rotl(r, 7)
+    *result = r + (r << 3); // r * 9
+    *s2 ^= *s0;
+    *s3 ^= *s1;
+    *s1 ^= *s2;
+    *s0 ^= *s3;
+    *s2 ^= t;
+    *s3 = (*s3 << 11) | (*s3 >> 21); // rotl(s3, 11)
+}
+#else
+static inline uint32_t rng_block_step_lane(RNGBlock *blk, int lane) {
+    uint32_t *s0 = &blk->s[0][lane], *s1 = &blk->s[1][lane];
+    uint32_t *s2 = &blk->s[2][lane], *s3 = &blk->s[3][lane];
+    uint32_t r = *s1 * 5;
+    uint32_t t = *s1 << 9;
+    r = ((r << 7) | (r >> 25)) * 9;
+    *s2 ^= *s0;
+    *s3 ^= *s1;
+    *s1 ^= *s2;
+    *s0 ^= *s3;
+    *s2 ^= t;
+    *s3 = (*s3 << 11) | (*s3 >> 21);
+    return r;
+}
+#endif
+
+void rng_block_fill_u32(RNGBlock *blk) {
+    /* Refill the u32 buffer with RNG_BLOCK_SIZE new values */
+    int i;
+#ifdef RNG_BLOCK_SIMD
+    u32xL s0, s1, s2, s3, r;
+    memcpy(&s0, blk->s[0], sizeof(s0));
+    memcpy(&s1, blk->s[1], sizeof(s1));
+    memcpy(&s2, blk->s[2], sizeof(s2));
+    memcpy(&s3, blk->s[3], sizeof(s3));
+    for(i = 0; i < RNG_BLOCK_SIZE; i += RNG_BLOCK_LANES) {
+        rng_block_step(&s0, &s1, &s2, &s3, &r);
+        memcpy(&blk->u32[i], &r, sizeof(r));
+    }
+    memcpy(blk->s[0], &s0, sizeof(s0));
+    memcpy(blk->s[1], &s1, sizeof(s1));
+    memcpy(blk->s[2], &s2, sizeof(s2));
+    memcpy(blk->s[3], &s3, sizeof(s3));
+#else
+    int lane;
+    for(i = 0; i < RNG_BLOCK_SIZE; i += RNG_BLOCK_LANES) {
+        for(lane = 0; lane < RNG_BLOCK_LANES; lane++) {
+            blk->u32[i + lane] = rng_block_step_lane(blk, lane);
+        }
+    }
+#endif
+    blk->u32_cursor = 0;
+}
+
+void rng_block_fill_real(RNGBlock *blk) {
+    /* Refill the float buffer with RNG_BLOCK_SIZE new values on [0,1). The
+     * top 24 bits fill the float mantissa exactly. */
+    int i;
+    const float scale = 1.0f / 16777216.0f;
+#ifdef RNG_BLOCK_SIMD
+    u32xL s0, s1, s2, s3, r;
+    f32xL f;
+    memcpy(&s0, blk->s[0], sizeof(s0));
+    memcpy(&s1, blk->s[1], sizeof(s1));
+    memcpy(&s2, blk->s[2], sizeof(s2));
+    memcpy(&s3, blk->s[3], sizeof(s3));
+    for(i = 0; i < RNG_BLOCK_SIZE; i += RNG_BLOCK_LANES) {
+        rng_block_step(&s0, &s1, &s2, &s3, &r);
+        f = __builtin_convertvector((i32xL)(r >> 8), f32xL) * scale;
+        memcpy(&blk->real[i], &f, sizeof(f));
+    }
+    memcpy(blk->s[0], &s0, sizeof(s0));
+    memcpy(blk->s[1], &s1, sizeof(s1));
+    memcpy(blk->s[2], &s2, sizeof(s2));
+    memcpy(blk->s[3], &s3, sizeof(s3));
+#else
+    int lane;
+    for(i = 0; i < RNG_BLOCK_SIZE; i += RNG_BLOCK_LANES) {
+        for(lane = 0; lane < RNG_BLOCK_LANES; lane++) {
+            blk->real[i + lane] = 
+                (float)(rng_block_step_lane(blk, lane) >> 8) * scale;
+        }
+    }
+#endif
+    blk->real_cursor = 0;
+}
+
+int rng_block_range(RNGBlock *blk, int min, int max) {
+    /* Random int on [min,max], same Lemire method as rng_bounded */
+    uint32_t range = (uint32_t)(max - min) + 1;
+    uint64_t m = (uint64_t)rng_block_next(blk) * range;
+    uint32_t low = (uint32_t)m;
+    uint32_t threshold = 0;
+    if(low < range) {
+        threshold = -range % range;
+        while(low < threshold) {
+            m = (uint64_t)rng_block_next(blk) * range;
+            low = (uint32_t)m;
+        }
+    }
+    return (int)(m >> 32) + min;
+}
+
+bool rng_block_bool(RNGBlock *blk) {
+    if(!blk->nbits) {
+        blk->bits = rng_block_next(blk);
+        blk->nbits = 32;
+    }
+    blk->nbits -= 1;
+    return (blk->bits >> blk->nbits) & 1;
+}
+
+RNGBlock* rng_block_global(void) {
+    /* The block the mt_fast_* functions use. Seeded from the global RNG, so
+     * mt_seed() controls it too. */
+    RNGContext *ctx = rng_context ? rng_context : &rng_default;
+    RNG *rng = NULL;
+    uint64_t hi, lo;
+    if(!ctx->blockseeded) {
+        rng = rng_global();
+        // One at a time, C doesn't say which of two calls in a line goes first
+        hi = rng_next(rng);
+        lo = rng_next(rng);
+        rng_block_seed(&ctx->block, (hi << 32) | lo);
+        ctx->blockseeded = true;
+    }
+    return &ctx->block;
+}
+
+/*****
+ * Convenience functions on the global RNG
+ *****/
+void mt_seed(unsigned long seed) {
+    RNGContext *ctx = rng_context ? rng_context : &rng_default;
+    rng_seed(&ctx->rng, seed);
+    ctx->seeded = true;
+    ctx->blockseeded = false; // Reseed from the new state on next use
+}
+
+double mt_real(void) {
+    return rng_real1(rng_global());
+}
+
+int mt_rand(int min, int max) {
+    /* Random int on [min,max], both ends included */
+    return (int)rng_bounded(rng_global(), (uint32_t)(max - min) + 1) + min;
+}
+
+bool mt_bool(void) {
+    return rng_bits(rng_global(), 1);
+}
+
+bool mt_chance(int chance) {
+    /* Idea: I want a 1/3 chance of something happening, so I call
+     * mt_chance(33). It gets a random number between 0 and 99 from 7 reservoir
+     * bits (throwing out 100-127), and then returns true if the random number
+     * is less than 33. */
+    RNG *rng = rng_global();
+    uint32_t result = 0;
+    do {
+        result = rng_bits(rng, 7);
+    } while(result >= 100);
+    return((int)result < chance);
+}
+
+float mt_fast_real(void) {
+    /* Random float on [0,1) from the block generator */
+    return rng_block_real(rng_block_global());
+}
+
+int mt_fast_rand(int min, int max) {
+    /* Random int on [min,max] from the block generator */
+    return rng_block_range(rng_block_global(), min, max);
+}
+
+bool mt_fast_bool(void) {
+    return rng_block_bool(rng_block_global());
+}
@@ -0,0 +1,192 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+typedef struct {
+    WSL_App **sims;
+    int count;
+    long *left; // Ticks each sim still has to run, 0 once it's done
+    bool *busy; // Being updated by one of the threads right now
+    int running; // Sims busy right now
+    SDL_mutex *lock;
+    SDL_cond *freed; // A sim went back in line
+} SimBatch;
+
+WSL_App* sim_create(uint64_t seed) {
+    /*
+     * A new game, ready to start on its first update. Everything random in
+     * it comes from seed, the same as a --headless game with --seed.
+     */
+    WSL_App *sim = calloc(1, sizeof(WSL_App));
+    RNGContext *outer = NULL;
+    if(!sim) return NULL;
+    sim->rng = aligned_alloc(_Alignof(RNGContext), sizeof(RNGContext));
+    sim->scores = calloc(NUM_HIGHSCORES, sizeof(Highscore));
+    if(!sim->rng || !sim->scores) {
+        free(sim->rng);
+        free(sim->scores);
+        free(sim);
+        return NULL;
+    }
+    memset(sim->rng, 0, sizeof(RNGContext));
+    sim->backend = RB_HEADLESS;
+    sim->running = true;
+    sim->alpha = 1.0;
+    set_tick_rate(sim, BASE_TICK_RATE);
+
+    // Made up high scores, then the game's seed
+    outer = rng_use_context(sim->rng);
+    create_scores(sim);
+    mt_seed(seed);
+    rng_use_context(outer);
+    sim->seed = seed;
+
+    sim->asteroidspawn = secs_to_ticks(sim, ASTEROID_SPAWN_FIRST);
+    sim->state = GS_NEW;
+    return sim;
+}
+
+void sim_destroy(WSL_App *sim) {
+    Entity *entity = NULL;
+    if(!sim) return;
+    replay_close(sim->replay, sim);
+    autopilot_destroy(sim->autopilot);
+    while(sim->entities) {
+        entity = sim->entities;
+        sim->entities = entity->next;
+        destroy_entity(entity);
+    }
+    free(sim->particles);
+    close_scores(sim);
+    free(sim->rng);
+    free(sim);
+}
+
+static int sim_next(SimBatch *batch) {
+    /* The waiting sim with the most ticks left, or -1 if none are waiting.
+     * Called with the lock held. */
+    int i, next = -1;
+    for(i = 0; i < batch->count; i++) {
+        if(batch->busy[i] || !batch->left[i]) continue;
+        if((next < 0) || (batch->left[i] > batch->left[next])) next = i;
+    }
+    return next;
+}
+
+static void sim_job(void *data, int index) {
+    /*
+     * One of the pool's threads, taking sims SIM_SLICE_TICKS updates at a
+     * time until there's nothing left. A sim is only ever on one thread at a
+     * time, and goes back in line after each slice for whichever thread is
+     * free next. A thread with nothing to take waits for a sim to come back
+     * rather than leaving early, in case it still has ticks to run.
+     */
+    SimBatch *batch = data;
+    WSL_App *sim = NULL;
+    long i, slice;
+    int next;
+    SDL_LockMutex(batch->lock);
+    while(true) {
+        next = sim_next(batch);
+        if(next < 0) {
+            if(!batch->running) break;
+            SDL_CondWait(batch->freed, batch->lock);
+            continue;
+        }
+        sim = batch->sims[next];
+        slice = batch->left[next] < SIM_SLICE_TICKS ? batch->left[next] :
+            SIM_SLICE_TICKS;
+        batch->busy[next] = true;
+        batch->running += 1;
+        SDL_UnlockMutex(batch->lock);
+
+        for(i = 0; (i < slice) && sim->running; i++) {
+            update(sim);
+        }
+
+        SDL_LockMutex(batch->lock);
+        batch->left[next] = sim->running ? batch->left[next] - slice : 0;
+        batch->busy[next] = false;
+        batch->running -= 1;
+        SDL_CondBroadcast(batch->freed);
+    }
+    SDL_UnlockMutex(batch->lock);
+}
+
+uint64_t sim_run(WSL_Pool *pool, WSL_App **sims, int count, long ticks) {
+    /*
+     * Update every sim ticks times, spread over the pool. Each sim runs in
+     * slices of SIM_SLICE_TICKS updates, handed out to whichever thread is
+     * free next, longest left first, so one slow sim doesn't hold a thread
+     * to itself while the rest sit idle. Returns the nanoseconds it took.
+     */
+    SimBatch batch = {0};
+    uint64_t start, elapsed;
+    int i;
+    batch.sims = sims;
+    batch.count = count;
+    batch.left = malloc(sizeof(long) * count);
+    batch.busy = calloc(count, sizeof(bool));
+    batch.lock = SDL_CreateMutex();
+    batch.freed = SDL_CreateCond();
+    if(!batch.left || !batch.busy || !batch.lock || !batch.freed) {
+        printf("Unable to start the sims!\n");
+        count = 0;
+    }
+    for(i = 0; i < count; i++) {
+        batch.left[i] = sims[i] ? ticks : 0;
+    }
+    start = wsl_clock_now();
+    if(count) {
+        wsl_pool_run(pool, &sim_job, &batch, wsl_pool_threads(pool));
+    }
+    elapsed = wsl_clock_now() - start;
+    if(batch.freed) SDL_DestroyCond(batch.freed);
+    if(batch.lock) SDL_DestroyMutex(batch.lock);
+    free(batch.busy);
+    free(batch.left);
+    return elapsed;
+}
+
+void sim_report(WSL_App **sims, int count, int threads, uint64_t elapsed) {
+    /* Ticks per second for all of them together, and per thread */
+    double secs = (double)elapsed / NS_PER_SEC;
+    uint64_t updates = 0;
+    long games = 0;
+    long long score = 0;
+    double rate;
+    int i;
+    for(i = 0; i < count; i++) {
+        updates += sims[i]->stats.updates;
+        if(sims[i]->autopilot) {
+            games += sims[i]->autopilot->games;
+            score += sims[i]->autopilot->totalscore;
+        }
+    }
+    rate = secs > 0 ? updates / secs : 0;
+    printf("%d sims on %d thread(s): %llu ticks in %.3f s, %.0f ticks/s "
+            "(%.0f a thread)\n", count, threads, (unsigned long long)updates,
+            secs, rate, rate / threads);
+    if(games) {
+        printf("Autopilot: %ld games over, average score %.0f\n", games,
+                (double)score / games);
+    }
+}
@@ -0,0 +1,390 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+typedef void (*SnapshotFunc)(Entity*, WSL_App*);
+
+/*
+ * Every function an entity can point at. A snapshot stores the index, 0 is
+ * NULL. New entity functions go on the end, the numbers are in snapshots.
+ */
+static const SnapshotFunc snapshot_funcs[] = {
+    NULL,
+    &update_player, &player_render, &player_damage,
+    &update_projectile, &update_projectile_flash, &projectile_impact_death,
+    &ufo_update, &ufo_damage, &ufo_death,
+    &update_asteroid, &asteroid_damage, &asteroid_death, &asteroid_sm_death,
+    &update_particle, &render_particle_test,
+    &firework_death,
+    &update_bliptxt, &bliptxt_render,
+    &update_pickup, &shield_pickup_death, &small_points_pickup_death,
+    &med_points_pickup_death, &lg_points_pickup_death,
+    &entity_render,
+};
+#define SNAPSHOT_FUNCS ((int)(sizeof(snapshot_funcs) / sizeof(snapshot_funcs[0])))
+
+typedef struct {
+    int state;
+    int score;
+    int asteroidspawn;
+    int tickrate;
+    uint64_t tick;
+    float bgoffset[NUM_BG_LAYERS];
+    uint8_t keyboard[(MAX_KEYBOARD_KEYS + 7) / 8]; // One bit a key
+} SnapshotGame;
+
+/*
+ * The random numbers, without the block generator's spent values: its lane
+ * states and cursors, then only the u32[] and real[] values not handed out
+ * yet follow (RNG_BLOCK_SIZE - cursor of each).
+ */
+typedef struct {
+    uint32_t rng[RNG_PACKED_WORDS]; // rng_pack()ed
+    uint32_t s[4][RNG_BLOCK_LANES];
+    uint32_t bits;
+    int32_t nbits;
+    uint16_t u32_cursor;
+    uint16_t real_cursor;
+    uint8_t seeded;
+    uint8_t blockseeded;
+} SnapshotRNG;
+
+typedef struct {
+    float x;
+    float y;
+    float dx;
+    float dy;
+    double angle;
+    float prevx;
+    float prevy;
+    double prevangle;
+    SDL_Rect aabb;
+    int speed;
+    int cooldown;
+    int frame;
+    int flags;
+    int health;
+    int layer;
+    uint8_t rgba[4];
+    SDL_Rect spriterect;
+    float spritescale;
+    uint8_t funcs[4]; // update, render, take_damage, deathfunc
+    uint16_t txtlen; // Bytes of text that follow, the 0 included, or 0
+    uint8_t hasai; // An EntityAI follows
+} SnapshotEntity;
+
+/*****
+ * Writing
+ *****/
+static bool snapshot_reserve(Snapshot *snap, size_t bytes) {
+    /* Room for bytes more, doubling the buffer when it runs out */
+    size_t max = snap->max ? snap->max : 4096;
+    uint8_t *grown = NULL;
+    if(snap->size + bytes <= snap->max) return true;
+    while(max < snap->size + bytes) max *= 2;
+    grown = realloc(snap->data, max);
+    if(!grown) return false;
+    snap->data = grown;
+    snap->max = max;
+    return true;
+}
+
+static void snapshot_put(Snapshot *snap, const void *src, size_t bytes) {
+    /* Only after snapshot_reserve made room */
+    memcpy(snap->data + snap->size, src, bytes);
+    snap->size += bytes;
+}
+
+static bool snapshot_put_rng(Snapshot *snap, RNGContext *ctx) {
+    SnapshotRNG rec;
+    RNGBlock *blk = &ctx->block;
+    size_t u32s = RNG_BLOCK_SIZE - blk->u32_cursor;
+    size_t reals = RNG_BLOCK_SIZE - blk->real_cursor;
+    if(!snapshot_reserve(snap, sizeof(rec) + (u32s * sizeof(uint32_t)) +
+                (reals * sizeof(float)))) {
+        return false;
+    }
+    memset(&rec, 0, sizeof(rec));
+    rng_pack(&ctx->rng, rec.rng);
+    memcpy(rec.s, blk->s, sizeof(rec.s));
+    rec.bits = blk->bits;
+    rec.nbits = blk->nbits;
+    rec.u32_cursor = blk->u32_cursor;
+    rec.real_cursor = blk->real_cursor;
+    rec.seeded = ctx->seeded;
+    rec.blockseeded = ctx->blockseeded;
+    snapshot_put(snap, &rec, sizeof(rec));
+    snapshot_put(snap, blk->u32 + blk->u32_cursor, u32s * sizeof(uint32_t));
+    snapshot_put(snap, blk->real + blk->real_cursor, reals * sizeof(float));
+    return true;
+}
+
+static uint8_t snapshot_func_tag(SnapshotFunc func) {
+    int i;
+    for(i = 0; i < SNAPSHOT_FUNCS; i++) {
+        if(snapshot_funcs[i] == func) return i;
+    }
+    printf("Entity function %p isn't in snapshot_funcs!\n", (void*)func);
+    return 0;
+}
+
+static bool snapshot_put_entity(Snapshot *snap, Entity *e) {
+    SnapshotEntity rec;
+    size_t txtlen = e->txt ? strlen(e->txt) + 1 : 0;
+    if(txtlen > UINT16_MAX) txtlen = 0; // Nothing says anything that long
+    if(!snapshot_reserve(snap, sizeof(rec) + sizeof(EntityAI) + txtlen)) {
+        return false;
+    }
+    memset(&rec, 0, sizeof(rec)); // Padding too, same state same bytes
+    rec.x = e->x;
+    rec.y = e->y;
+    rec.dx = e->dx;
+    rec.dy = e->dy;
+    rec.angle = e->angle;
+    rec.prevx = e->prevx;
+    rec.prevy = e->prevy;
+    rec.prevangle = e->prevangle;
+    rec.aabb = e->aabb;
+    rec.speed = e->speed;
+    rec.cooldown = e->cooldown;
+    rec.frame = e->frame;
+    rec.flags = e->flags;
+    rec.health = e->health;
+    rec.layer = e->layer;
+    memcpy(rec.rgba, e->rgba, sizeof(rec.rgba));
+    rec.spriterect = e->spriterect;
+    rec.spritescale = e->spritescale;
+    rec.funcs[0] = snapshot_func_tag(e->update);
+    rec.funcs[1] = snapshot_func_tag(e->render);
+    rec.funcs[2] = snapshot_func_tag(e->take_damage);
+    rec.funcs[3] = snapshot_func_tag(e->deathfunc);
+    rec.txtlen = txtlen;
+    rec.hasai = e->ai != NULL;
+    snapshot_put(snap, &rec, sizeof(rec));
+    if(e->ai) snapshot_put(snap, e->ai, sizeof(EntityAI));
+    if(txtlen) snapshot_put(snap, e->txt, txtlen);
+    return true;
+}
+
+bool snapshot_save(WSL_App *game, Snapshot *snap) {
+    /*
+     * Write the game's state into snap, over whatever was in it. Returns
+     * false if the buffer couldn't grow (snap is no good then).
+     */
+    RNGContext *rng = game->rng ? game->rng : rng_current_context();
+    SnapshotGame g;
+    Entity *e = NULL;
+    uint8_t header[SNAPSHOT_HEADER_SIZE];
+    uint32_t rngsize = sizeof(SnapshotRNG), count = 0;
+    int i;
+
+    snap->size = 0;
+    if(!snapshot_reserve(snap, SNAPSHOT_HEADER_SIZE + sizeof(g))) {
+        return false;
+    }
+    memset(&g, 0, sizeof(g));
+    g.state = game->state;
+    g.score = game->score;
+    g.asteroidspawn = game->asteroidspawn;
+    g.tickrate = game->tickrate;
+    g.tick = game->tick;
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        g.bgoffset[i] = game->bg[i].offset;
+    }
+    for(i = 0; i < MAX_KEYBOARD_KEYS; i++) {
+        if(game->keyboard[i]) g.keyboard[i / 8] |= 1 << (i % 8);
+    }
+
+    // Header's filled in at the end, once the entities are counted
+    snap->size = SNAPSHOT_HEADER_SIZE;
+    snapshot_put(snap, &g, sizeof(g));
+    if(!snapshot_put_rng(snap, rng)) return false;
+    for(e = game->entities; e; e = e->next) {
+        if(!snapshot_put_entity(snap, e)) return false;
+        count += 1;
+    }
+    memcpy(header, SNAPSHOT_MAGIC, 4);
+    header[4] = SNAPSHOT_VERSION;
+    memcpy(header + 5, &rngsize, 4);
+    memcpy(header + 9, &count, 4);
+    memcpy(snap->data, header, SNAPSHOT_HEADER_SIZE);
+    return true;
+}
+
+/*****
+ * Reading
+ *****/
+static Entity* snapshot_get_entity(const Snapshot *snap, size_t *pos) {
+    /* The next entity, or NULL if it's cut short or makes no sense */
+    SnapshotEntity rec;
+    Entity *e = NULL;
+    int i;
+    if(*pos + sizeof(rec) > snap->size) return NULL;
+    memcpy(&rec, snap->data + *pos, sizeof(rec));
+    *pos += sizeof(rec);
+    for(i = 0; i < 4; i++) {
+        if(rec.funcs[i] >= SNAPSHOT_FUNCS) return NULL;
+    }
+    if(*pos + (rec.hasai ? sizeof(EntityAI) : 0) + rec.txtlen > snap->size) {
+        return NULL;
+    }
+    e = create_entity(rec.spriterect);
+    if(!e) return NULL;
+    e->x = rec.x;
+    e->y = rec.y;
+    e->dx = rec.dx;
+    e->dy = rec.dy;
+    e->angle = rec.angle;
+    e->prevx = rec.prevx;
+    e->prevy = rec.prevy;
+    e->prevangle = rec.prevangle;
+    e->aabb = rec.aabb;
+    e->speed = rec.speed;
+    e->cooldown = rec.cooldown;
+    e->frame = rec.frame;
+    e->flags = rec.flags;
+    e->health = rec.health;
+    e->layer = rec.layer;
+    memcpy(e->rgba, rec.rgba, sizeof(rec.rgba));
+    e->spritescale = rec.spritescale;
+    e->update = snapshot_funcs[rec.funcs[0]];
+    e->render = snapshot_funcs[rec.funcs[1]];
+    e->take_damage = snapshot_funcs[rec.funcs[2]];
+    e->deathfunc = snapshot_funcs[rec.funcs[3]];
+    if(rec.hasai) {
+        e->ai = malloc(sizeof(EntityAI));
+        if(e->ai) memcpy(e->ai, snap->data + *pos, sizeof(EntityAI));
+        *pos += sizeof(EntityAI);
+    }
+    if(rec.txtlen) {
+        e->txt = malloc(rec.txtlen);
+        if(e->txt) {
+            memcpy(e->txt, snap->data + *pos, rec.txtlen);
+            e->txt[rec.txtlen - 1] = '\0';
+        }
+        *pos += rec.txtlen;
+    }
+    if((rec.hasai && !e->ai) || (rec.txtlen && !e->txt)) {
+        destroy_entity(e);
+        return NULL;
+    }
+    return e;
+}
+
+bool snapshot_restore(WSL_App *game, const Snapshot *snap) {
+    /*
+     * Put the game back the way it was when snap was taken. The snapshot is
+     * checked over as it's read; if it's no good the game is left alone and
+     * this returns false.
+     */
+    RNGContext *rng = game->rng ? game->rng : rng_current_context();
+    SnapshotGame g;
+    SnapshotRNG r;
+    Entity *head = NULL, *tail = NULL, *e = NULL;
+    uint32_t rngsize, count, i;
+    size_t pos = SNAPSHOT_HEADER_SIZE, rngpos, u32s, reals;
+    bool ok = true;
+
+    if(!snap->data || (snap->size < SNAPSHOT_HEADER_SIZE + sizeof(g) +
+                sizeof(r)) ||
+            (memcmp(snap->data, SNAPSHOT_MAGIC, 4) != 0) ||
+            (snap->data[4] != SNAPSHOT_VERSION)) {
+        return false;
+    }
+    memcpy(&rngsize, snap->data + 5, 4);
+    memcpy(&count, snap->data + 9, 4);
+    if(rngsize != sizeof(SnapshotRNG)) return false; // Another build's
+    memcpy(&g, snap->data + pos, sizeof(g));
+    pos += sizeof(g);
+    memcpy(&r, snap->data + pos, sizeof(r));
+    pos += sizeof(r);
+    if((r.u32_cursor > RNG_BLOCK_SIZE) || (r.real_cursor > RNG_BLOCK_SIZE)) {
+        return false;
+    }
+    u32s = RNG_BLOCK_SIZE - r.u32_cursor;
+    reals = RNG_BLOCK_SIZE - r.real_cursor;
+    rngpos = pos;
+    pos += (u32s * sizeof(uint32_t)) + (reals * sizeof(float));
+    if(pos > snap->size) return false;
+
+    // Build the new list on the side, then swap it in
+    for(i = 0; (i < count) && ok; i++) {
+        e = snapshot_get_entity(snap, &pos);
+        if(!e) {
+            ok = false;
+            break;
+        }
+        if(tail) {
+            tail->next = e;
+            e->prev = tail;
+        } else {
+            head = e;
+        }
+        tail = e;
+    }
+    if(!ok) {
+        while(head) {
+            e = head;
+            head = head->next;
+            destroy_entity(e);
+        }
+        return false;
+    }
+
+    while(game->entities) {
+        e = game->entities;
+        game->entities = e->next;
+        destroy_entity(e);
+    }
+    game->entities = head;
+    game->numparticles = 0;
+    game->state = g.state;
+    game->score = g.score;
+    game->asteroidspawn = g.asteroidspawn;
+    set_tick_rate(game, g.tickrate);
+    game->tick = g.tick;
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        game->bg[i].offset = g.bgoffset[i];
+    }
+    for(i = 0; i < MAX_KEYBOARD_KEYS; i++) {
+        game->keyboard[i] = (g.keyboard[i / 8] >> (i % 8)) & 1;
+    }
+    rng_unpack(&rng->rng, r.rng);
+    memcpy(rng->block.s, r.s, sizeof(r.s));
+    rng->block.bits = r.bits;
+    rng->block.nbits = r.nbits;
+    rng->block.u32_cursor = r.u32_cursor;
+    rng->block.real_cursor = r.real_cursor;
+    memcpy(rng->block.u32 + r.u32_cursor, snap->data + rngpos,
+            u32s * sizeof(uint32_t));
+    rngpos += u32s * sizeof(uint32_t);
+    memcpy(rng->block.real + r.real_cursor, snap->data + rngpos,
+            reals * sizeof(float));
+    rng->seeded = r.seeded;
+    rng->blockseeded = r.blockseeded;
+    return true;
+}
+
+void snapshot_free(Snapshot *snap) {
+    free(snap->data);
+    snap->data = NULL;
+    snap->size = snap->max = 0;
+}
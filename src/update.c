@@ -25,8 +25,31 @@ void update_newgame(WSL_App *game);
 void update_game(WSL_App *game);
 void update_scores(WSL_App *game);
 void update_gameover(WSL_App *game);
+void update_entities(WSL_App *game);
+void update_background(WSL_App *game);
+void update_cooldown(Entity *entity);
 
 void update(WSL_App *game) {
+    /* Everything is drawn blended from where it is now to where this update
+     * moves it, so remember where that was first */
+    Entity *entity = NULL;
+    WSL_Stats *stats = &game->stats;
+    uint64_t begin = wsl_clock_now(), start = begin, mark;
+    uint64_t busy = stats->phase[UP_ENTITIES] + stats->phase[UP_PARTICLES];
+    int count = 0, bucket = 0;
+    // A game with random numbers of its own draws them all from those
+    RNGContext *outer = game->rng ? rng_use_context(game->rng) : NULL;
+    if(game->autopilot) {
+        autopilot_update(game->autopilot, game); // Before it's recorded
+        start = wsl_clock_now();
+        stats->phase[UP_AUTOPILOT] += start - begin;
+    }
+    replay_update(game->replay, game); // Recorded keyboard in or out
+    for(entity = game->entities; entity; entity = entity->next) {
+        entity_snapshot(entity);
+    }
+    mark = wsl_clock_now();
+    stats->phase[UP_SNAPSHOT] += mark - start;
     switch(game->state) {
         case GS_MENU:
             update_menu(game);
@@ -46,28 +69,120 @@ void update(WSL_App *game) {
         default:
             break;
     }
+    // Whatever update_entities didn't count is the cleanup
+    start = wsl_clock_now();
+    busy = stats->phase[UP_ENTITIES] + stats->phase[UP_PARTICLES] - busy;
+    stats->phase[UP_CLEANUP] += (start - mark) - busy;
+    // And where it's drawn between the two, for culling
+    for(entity = game->entities; entity; entity = entity->next) {
+        entity_update_aabb(entity);
+        count += 1;
+    }
+    mark = wsl_clock_now();
+    stats->phase[UP_SNAPSHOT] += mark - start;
+    stats->updates += 1;
+    game->tick += 1;
+    if(count > stats->peakentities) stats->peakentities = count;
+    // Histogram of how long the whole update took, in doubling microseconds
+    for(mark = (mark - begin) / 2000; mark && (bucket < TICK_HIST_BUCKETS - 1);
+            mark >>= 1) {
+        bucket += 1;
+    }
+    stats->tickhist[bucket] += 1;
+    if(game->rng) rng_use_context(outer);
+}
+
+int update_steps(WSL_App *game, uint64_t *lag, uint64_t step, int maxsteps) {
+    /*
+     * Run an update for every whole step in lag, taking them off it, but no
+     * more than maxsteps (0 for no limit). After a stall, catching up all the
+     * way would make the frame take even longer, and the next frame longer
+     * still, so past maxsteps the whole steps left over are dropped (the game
+     * slows down instead) and counted in the stats. Returns the updates run.
+     */
+    uint64_t dropped = 0;
+    int steps = 0;
+    while(*lag >= step) {
+        if(maxsteps && (steps == maxsteps)) {
+            dropped = *lag - (*lag % step);
+            *lag -= dropped;
+            game->stats.capped += 1;
+            game->stats.dropped += dropped;
+            break;
+        }
+        *lag -= step;
+        update(game);
+        steps += 1;
+    }
+    if(steps > 1) game->stats.catchups += 1;
+    return steps;
+}
+
+/*****
+ * Tick rate
+ *****/
+void set_tick_rate(WSL_App *game, int tickrate) {
+    /*
+     * Change how many updates make a second. Timers count ticks, so they're
+     * set from seconds with secs_to_ticks, and anything that moves or turns
+     * by so much an update is tuned for BASE_TICK_RATE and multiplied by
+     * tickscale. Either way the game plays out at the same speed.
+     */
+    if(tickrate < MIN_TICK_RATE) tickrate = MIN_TICK_RATE;
+    if(tickrate > MAX_TICK_RATE) tickrate = MAX_TICK_RATE;
+    game->tickrate = tickrate;
+    game->tickscale = (float)BASE_TICK_RATE / tickrate;
+}
+
+int secs_to_ticks(WSL_App *game, float seconds) {
+    /* Nearest whole number of ticks, but never rounds something down to 0 */
+    int ticks = (int)(seconds * game->tickrate + 0.5f);
+    if((seconds > 0) && (ticks < 1)) ticks = 1;
+    return ticks;
+}
+
+bool tick_every(WSL_App *game, int tick, float seconds) {
+    /* True once every seconds, for a counter going up (or down) each tick */
+    return (tick % secs_to_ticks(game, seconds)) == 0;
+}
+
+bool tick_blink(WSL_App *game, int tick, float seconds) {
+    /* On for seconds, off for seconds, and so on */
+    return ((tick / secs_to_ticks(game, seconds)) % 2) == 0;
+}
+
+int tick_scale_count(WSL_App *game, int count) {
+    /*
+     * Scale a number of things spawned every tick, rounding up or down at
+     * random so the average over a second comes out the same.
+     */
+    if(game->tickscale == 1.0f) return count;
+    return (int)((count * game->tickscale) + mt_real());
+}
+
+void update_cooldown(Entity *entity) {
+    /*
+     * Count down an entity's timer, once every update starting with the one
+     * it was set in. EF_COOLDOWN goes off in the update it runs out, so a
+     * timer set to secs_to_ticks(game, s) is over exactly s later, with no
+     * extra ticks at the end to make it last longer at lower tick rates.
+     */
+    if(entity->cooldown) entity->cooldown -= 1;
+    if(!entity->cooldown) entity->flags &= ~EF_COOLDOWN;
 }
 
 void update_menu(WSL_App *game) {
     Entity *entity = NULL, *tmp = NULL;
 
     // Update entities
-    entity = game->entities;
-    while(entity) {
-        entity->update(entity,game);
-        entity = entity->next;
-    }
+    update_entities(game);
     
     // Cleanup entity list
     entity = game->entities;
     while(entity) {
         tmp = entity;
         entity = entity->next;
-        if(tmp->cooldown) {
-            tmp->cooldown -= 1;
-        } else {
-            tmp->flags &= ~EF_COOLDOWN;
-        }
+        update_cooldown(tmp);
         if(!((tmp->flags & EF_ALIVE) == EF_ALIVE)) {
             //Entity is dead, call death function, remove it
             if(tmp->deathfunc) tmp->deathfunc(tmp, game);
@@ -76,16 +191,55 @@ void update_menu(WSL_App *game) {
     }
 
     // Check enemy spawn timer
-    if(game->asteroidspawn) {
-        game->asteroidspawn -= 1;
-    } else {
+    if(game->asteroidspawn) game->asteroidspawn -= 1;
+    if(!game->asteroidspawn) {
         // Spawn asteroid, maybe
         spawn_asteroid(game);
     }
 
-    // Advance background
-    game->bgoffset += 4;
-    if(game->bgoffset > game->bg->h) game->bgoffset = 0;
+    update_background(game);
+}
+
+void update_entities(WSL_App *game) {
+    /*
+     * Update everything in the entity list. Particles are set aside and
+     * updated afterwards on the worker pool, everything else is updated in
+     * list order right here. Particles only ever touch themselves, and draw
+     * from streams of their own, so going last doesn't change anything else.
+     */
+    Entity *entity = game->entities;
+    Entity **grown = NULL;
+    uint64_t start = wsl_clock_now(), mark;
+    game->numparticles = 0;
+    while(entity) {
+        if(entity->update == &update_particle) {
+            if(game->numparticles == game->maxparticles) {
+                grown = realloc(game->particles, sizeof(Entity*) *
+                        (game->maxparticles ? game->maxparticles * 2 : 1024));
+                if(grown) {
+                    game->particles = grown;
+                    game->maxparticles = game->maxparticles ?
+                        game->maxparticles * 2 : 1024;
+                }
+            }
+            if(game->numparticles < game->maxparticles) {
+                game->particles[game->numparticles++] = entity;
+            } else {
+                entity->update(entity,game); // Out of memory, do it here
+            }
+        } else {
+            entity->update(entity,game);
+        }
+        entity = entity->next;
+    }
+
+    mark = wsl_clock_now();
+    game->stats.phase[UP_ENTITIES] += mark - start;
+
+    // The chunk streams come from the seed and tick, not the gameplay RNG
+    update_particles(game, game->particles, game->numparticles,
+            game->seed ^ (game->tick << 20));
+    game->stats.phase[UP_PARTICLES] += wsl_clock_now() - mark;
 }
 
 void update_newgame(WSL_App *game) {
@@ -105,8 +259,8 @@ void update_newgame(WSL_App *game) {
     player->x = (SCREEN_WIDTH / 2) - (playerrect.w / 2);
     player->y = (SCREEN_HEIGHT) - playerrect.h;
     player->flags |= EF_INV | EF_COOLDOWN; // Start "invulnerable"
-    player->frame = 60; //60fps, 120 is 2 seconds
-    player->cooldown = 25; // Can't shoot while "invulnerable"
+    player->frame = secs_to_ticks(game, PLAYER_SPAWN_INV);
+    player->cooldown = secs_to_ticks(game, PLAYER_FIRE_DELAY); // Can't shoot while "invulnerable"
     //player->txt = "SPUDS"; //Can't assign strings this way, just a reminder to
                              //do this (correctly) someday
     wsl_add_entity(game, player);
@@ -119,16 +273,22 @@ void update_newgame(WSL_App *game) {
     spawn_bliptxt(SCREEN_WIDTH/2 - (FONT_SIZE * 17)/2,
             SCREEN_HEIGHT/2 - FONT_SIZE,
             game,"G O O D   L U C K , C A D E T !",
-            90,30,
+            1.5,30,
             255,0,0,250);
     spawn_bliptxt(SCREEN_WIDTH/2 - (FONT_SIZE * 17)/2,
             SCREEN_HEIGHT/2 - FONT_SIZE,
             game,"G O O D   L U C K , C A D E T !",
-            30,0,
+            0.5,0,
             255,0,0,250);
 
-    // Reset the score
+    // Timers set here count this update, like any set in a game update
+    for(entity = game->entities; entity; entity = entity->next) {
+        update_cooldown(entity);
+    }
+
+    // Reset the score, and the first asteroid's on its way
     game->score = 0;
+    game->asteroidspawn = secs_to_ticks(game, ASTEROID_SPAWN_FIRST);
 
     // Switch the state
     game->state = GS_GAME;
@@ -138,22 +298,14 @@ void update_game(WSL_App *game) {
     Entity *entity = NULL, *tmp = NULL;
 
     // Update entities
-    entity = game->entities;
-    while(entity) {
-        entity->update(entity,game);
-        entity = entity->next;
-    }
+    update_entities(game);
 
     // Cleanup entity list
     entity = game->entities;
     while(entity) {
         tmp = entity;
         entity = entity->next;
-        if(tmp->cooldown) {
-            tmp->cooldown -= 1;
-        } else {
-            tmp->flags &= ~EF_COOLDOWN;
-        }
+        update_cooldown(tmp);
         if(!((tmp->flags & EF_ALIVE) == EF_ALIVE)) {
             //Entity is dead, call death function, remove it
             //if it's the player, change game state
@@ -161,7 +313,7 @@ void update_game(WSL_App *game) {
                 //Check player lives, subtract one if possible if not GAMEOVER
                 game->state = GS_GAMEOVER;
                 add_score(game, game->score);
-                spawn_bliptxt(0,0,game," ", 60,0,0,0,0,0); // Slight pause bliptxt
+                spawn_bliptxt(0,0,game," ", 1.0,0,0,0,0,0); // Slight pause bliptxt
             }
             if(tmp->deathfunc) tmp->deathfunc(tmp, game);
             wsl_destroy_entity(game, tmp);
@@ -169,16 +321,25 @@ void update_game(WSL_App *game) {
     }
 
     // Check enemy spawn timer
-    if(game->asteroidspawn) {
-        game->asteroidspawn -= 1;
-    } else {
+    if(game->asteroidspawn) game->asteroidspawn -= 1;
+    if(!game->asteroidspawn) {
         // Spawn asteroid
         spawn_asteroid(game);
     }
 
-    // Advance background
-    game->bgoffset += 4;
-    if(game->bgoffset > game->bg->h) game->bgoffset = 0;
+    update_background(game);
+}
+
+void update_background(WSL_App *game) {
+    /* Scroll each background layer along at its own speed */
+    WSL_BgLayer *layer = NULL;
+    int i;
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        layer = &game->bg[i];
+        if(!layer->tex || !layer->tex->h) continue;
+        layer->offset = fmodf(layer->offset + (layer->speed / game->tickrate),
+                layer->tex->h);
+    }
 }
 
 void update_scores(WSL_App *game) {
@@ -0,0 +1,127 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+WSL_Batch* wsl_batch_create(SDL_Renderer *renderer, WSL_Stats *stats) {
+    /*
+     * Sprite batcher. Quads are queued up with their color in the vertices
+     * (instead of modding the texture for every sprite) and sent to SDL in one
+     * SDL_RenderGeometry call, until the texture or blend mode changes, the
+     * batch fills up, or someone flushes it.
+     */
+    WSL_Batch *batch = malloc(sizeof(WSL_Batch));
+    int i;
+    if(!batch) return NULL;
+    batch->renderer = renderer;
+    batch->tex = NULL;
+    batch->blend = SDL_BLENDMODE_BLEND;
+    batch->count = 0;
+    batch->stats = stats;
+    batch->verts = malloc(sizeof(SDL_Vertex) * BATCH_MAX_QUADS * 4);
+    batch->indices = malloc(sizeof(int) * BATCH_MAX_QUADS * 6);
+    if(!batch->verts || !batch->indices) {
+        wsl_batch_destroy(batch);
+        return NULL;
+    }
+    // Two triangles per quad, the same for every quad
+    for(i = 0; i < BATCH_MAX_QUADS; i++) {
+        batch->indices[i*6 + 0] = i*4 + 0;
+        batch->indices[i*6 + 1] = i*4 + 1;
+        batch->indices[i*6 + 2] = i*4 + 2;
+        batch->indices[i*6 + 3] = i*4 + 2;
+        batch->indices[i*6 + 4] = i*4 + 3;
+        batch->indices[i*6 + 5] = i*4 + 0;
+    }
+    return batch;
+}
+
+void wsl_batch_destroy(WSL_Batch *batch) {
+    if(!batch) return;
+    free(batch->verts);
+    free(batch->indices);
+    free(batch);
+}
+
+void wsl_batch_flush(WSL_Batch *batch) {
+    /* Draw everything queued up */
+    if(!batch || !batch->count) return;
+    SDL_SetTextureBlendMode(batch->tex, batch->blend);
+    SDL_RenderGeometry(batch->renderer, batch->tex, batch->verts,
+            batch->count * 4, batch->indices, batch->count * 6);
+    if(batch->stats) {
+        batch->stats->drawcalls += 1;
+        batch->stats->sprites += batch->count;
+    }
+    batch->count = 0;
+}
+
+void wsl_batch_quad(WSL_Batch *batch, SDL_Texture *tex, SDL_BlendMode blend,
+        const SDL_Vertex *v) {
+    /* Queue one quad, four vertices going around the corners */
+    SDL_Vertex *dst = NULL;
+    if((batch->tex != tex) || (batch->blend != blend) ||
+            (batch->count == BATCH_MAX_QUADS)) {
+        wsl_batch_flush(batch);
+        batch->tex = tex;
+        batch->blend = blend;
+    }
+    dst = &batch->verts[batch->count * 4];
+    dst[0] = v[0];
+    dst[1] = v[1];
+    dst[2] = v[2];
+    dst[3] = v[3];
+    batch->count += 1;
+}
+
+void wsl_batch_sprite(WSL_Batch *batch, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color) {
+    /*
+     * Queue part of a texture drawn into dst, tinted by color and turned
+     * "angle" degrees clockwise around the middle of dst, the same as
+     * SDL_RenderCopyEx would draw it.
+     */
+    SDL_Vertex v[4];
+    float tw = 1.0f / t->w, th = 1.0f / t->h;
+    float left = src->x * tw, right = (src->x + src->w) * tw;
+    float top = src->y * th, bottom = (src->y + src->h) * th;
+    float hw = dst->w * 0.5f, hh = dst->h * 0.5f;
+    float cx = dst->x + hw, cy = dst->y + hh;
+    float s = 0, c = 1;
+    int i;
+
+    v[0].tex_coord = (SDL_FPoint){left, top};
+    v[1].tex_coord = (SDL_FPoint){right, top};
+    v[2].tex_coord = (SDL_FPoint){right, bottom};
+    v[3].tex_coord = (SDL_FPoint){left, bottom};
+    v[0].position = (SDL_FPoint){-hw, -hh};
+    v[1].position = (SDL_FPoint){hw, -hh};
+    v[2].position = (SDL_FPoint){hw, hh};
+    v[3].position = (SDL_FPoint){-hw, hh};
+    if(angle) fast_sincosf((float)(angle * (M_PI / 180.0)), &s, &c);
+    for(i = 0; i < 4; i++) {
+        float x = v[i].position.x, y = v[i].position.y;
+        v[i].position.x = cx + (x * c) - (y * s);
+        v[i].position.y = cy + (x * s) + (y * c);
+        v[i].color = color;
+    }
+    wsl_batch_quad(batch, t->tex, blend, v);
+}
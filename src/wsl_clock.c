@@ -0,0 +1,129 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+#include <time.h>
+
+#define CLOCK_MIN_SPIN (100 * 1000ULL) // Never trust a sleep closer than this
+#define CLOCK_MAX_SPIN (4 * NS_PER_MS) // Or spin for longer than this
+
+uint64_t wsl_clock_now(void) {
+    /* Nanoseconds since some fixed point, never goes backwards */
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+#else
+    static uint64_t freq = 0;
+    uint64_t count = SDL_GetPerformanceCounter();
+    if(!freq) freq = SDL_GetPerformanceFrequency();
+    return ((count / freq) * NS_PER_SEC) +
+        (((count % freq) * NS_PER_SEC) / freq);
+#endif
+}
+
+void wsl_clock_sleep(uint64_t ns) {
+    /* Give up the CPU for at least ns (the OS decides how much more) */
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    ts.tv_sec = ns / NS_PER_SEC;
+    ts.tv_nsec = ns % NS_PER_SEC;
+    nanosleep(&ts, NULL);
+#else
+    SDL_Delay((Uint32)(ns / NS_PER_MS));
+#endif
+}
+
+void wsl_clock_init(WSL_Clock *clock, uint64_t target) {
+    clock->target = target;
+    clock->deadline = wsl_clock_now() + target;
+    clock->spin = 1 * NS_PER_MS; // Until the sleeps show how good they are
+    wsl_clock_reset_stats(clock);
+}
+
+void wsl_clock_wait(WSL_Clock *clock, uint64_t deadline) {
+    /*
+     * Wait until deadline: sleep until the spin margin before it, then spin.
+     * Every sleep that wakes up late pushes the margin up to cover it, sleeps
+     * that wake up on time let it slowly fall back.
+     */
+    uint64_t now = wsl_clock_now(), want, over;
+    if(deadline > now + clock->spin) {
+        want = deadline - now - clock->spin;
+        wsl_clock_sleep(want);
+        over = wsl_clock_now() - now;
+        over = over > want ? over - want : 0;
+        if(over + CLOCK_MIN_SPIN > clock->spin) {
+            clock->spin = over + CLOCK_MIN_SPIN;
+        } else {
+            clock->spin -= (clock->spin - over - CLOCK_MIN_SPIN) / 16;
+        }
+        if(clock->spin > CLOCK_MAX_SPIN) clock->spin = CLOCK_MAX_SPIN;
+    }
+    while(wsl_clock_now() < deadline) {
+        // Spin
+    }
+}
+
+void wsl_clock_pace(WSL_Clock *clock) {
+    /*
+     * Call once a frame, after it's been drawn. Waits out the rest of the
+     * frame's target time and notes how far off the deadline it woke up.
+     * Frames are spaced from the last deadline, not from whenever the wait
+     * ended, so lateness doesn't add up, unless a frame ran more than a whole
+     * frame over: then the next one counts from now.
+     */
+    uint64_t now, late;
+    double delta;
+    if(!clock->target) return;
+    now = wsl_clock_now();
+    if(now >= clock->deadline) {
+        clock->missed += 1;
+    } else {
+        wsl_clock_wait(clock, clock->deadline);
+        now = wsl_clock_now();
+        late = now - clock->deadline;
+        // Running mean and variance (Welford)
+        clock->frames += 1;
+        delta = late - clock->mean;
+        clock->mean += delta / clock->frames;
+        clock->m2 += delta * (late - clock->mean);
+        if(late > clock->worst) clock->worst = late;
+    }
+    if(now - clock->deadline > clock->target) {
+        clock->deadline = now + clock->target;
+    } else {
+        clock->deadline += clock->target;
+    }
+}
+
+double wsl_clock_jitter_stddev(WSL_Clock *clock) {
+    /* Standard deviation of how late the waits ended, in ns */
+    if(clock->frames < 2) return 0;
+    return sqrt(clock->m2 / (clock->frames - 1));
+}
+
+void wsl_clock_reset_stats(WSL_Clock *clock) {
+    clock->frames = 0;
+    clock->missed = 0;
+    clock->mean = 0;
+    clock->m2 = 0;
+    clock->worst = 0;
+}
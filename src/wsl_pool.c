@@ -0,0 +1,144 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+static void wsl_pool_work(WSL_Pool *pool) {
+    /* Claim job indices until there are none left */
+    int i;
+    while((i = SDL_AtomicAdd(&pool->next, 1)) < pool->count) {
+        pool->job(pool->data, i);
+    }
+}
+
+static int wsl_pool_worker(void *data) {
+    WSL_Pool *pool = data;
+    // Batches are counted from when the pool was made, not from when this
+    // thread got going, the first one might already be waiting
+    unsigned int seen = 0;
+    SDL_LockMutex(pool->lock);
+    while(true) {
+        while((pool->batch == seen) && !pool->quit) {
+            SDL_CondWait(pool->wake, pool->lock);
+        }
+        if(pool->quit) break;
+        seen = pool->batch;
+        SDL_UnlockMutex(pool->lock);
+
+        wsl_pool_work(pool);
+
+        SDL_LockMutex(pool->lock);
+        pool->finished += 1;
+        if(pool->finished == pool->numthreads) SDL_CondSignal(pool->done);
+    }
+    SDL_UnlockMutex(pool->lock);
+    return 0;
+}
+
+WSL_Pool* wsl_pool_create(int threads) {
+    /*
+     * Create a pool where "threads" threads (the caller included) share the
+     * work, or one per CPU if threads < 1. A pool of 1 just runs everything on
+     * the caller.
+     */
+    WSL_Pool *pool = malloc(sizeof(WSL_Pool));
+    int i;
+    if(!pool) return NULL;
+    if(threads < 1) threads = SDL_GetCPUCount();
+    if(threads > MAX_WORKER_THREADS + 1) threads = MAX_WORKER_THREADS + 1;
+    pool->numthreads = 0;
+    pool->lock = SDL_CreateMutex();
+    pool->wake = SDL_CreateCond();
+    pool->done = SDL_CreateCond();
+    pool->job = NULL;
+    pool->data = NULL;
+    pool->count = 0;
+    SDL_AtomicSet(&pool->next, 0);
+    pool->finished = 0;
+    pool->batch = 0;
+    pool->quit = false;
+    if(!pool->lock || !pool->wake || !pool->done) {
+        printf("Unable to create worker pool. SDL Error: %s\n",
+                SDL_GetError());
+        wsl_pool_destroy(pool);
+        return NULL;
+    }
+    for(i = 0; i < threads - 1; i++) {
+        pool->threads[i] = SDL_CreateThread(&wsl_pool_worker, "worker", pool);
+        if(!pool->threads[i]) {
+            // Make do with the workers we have
+            printf("Unable to create worker thread. SDL Error: %s\n",
+                    SDL_GetError());
+            break;
+        }
+        pool->numthreads += 1;
+    }
+    return pool;
+}
+
+void wsl_pool_destroy(WSL_Pool *pool) {
+    int i;
+    if(!pool) return;
+    if(pool->lock) {
+        SDL_LockMutex(pool->lock);
+        pool->quit = true;
+        SDL_CondBroadcast(pool->wake);
+        SDL_UnlockMutex(pool->lock);
+    }
+    for(i = 0; i < pool->numthreads; i++) {
+        SDL_WaitThread(pool->threads[i], NULL);
+    }
+    if(pool->done) SDL_DestroyCond(pool->done);
+    if(pool->wake) SDL_DestroyCond(pool->wake);
+    if(pool->lock) SDL_DestroyMutex(pool->lock);
+    free(pool);
+}
+
+int wsl_pool_threads(WSL_Pool *pool) {
+    /* Threads sharing the work, caller included */
+    return pool ? pool->numthreads + 1 : 1;
+}
+
+void wsl_pool_run(WSL_Pool *pool, WSL_Job job, void *data, int count) {
+    /* Run job(data, i) for i in [0,count) and wait for all of them */
+    int i;
+    if(!pool || !pool->numthreads || (count < 2)) {
+        // Nothing to share, skip the wakeups
+        for(i = 0; i < count; i++) job(data, i);
+        return;
+    }
+    SDL_LockMutex(pool->lock);
+    pool->job = job;
+    pool->data = data;
+    pool->count = count;
+    SDL_AtomicSet(&pool->next, 0);
+    pool->finished = 0;
+    pool->batch += 1;
+    SDL_CondBroadcast(pool->wake);
+    SDL_UnlockMutex(pool->lock);
+
+    wsl_pool_work(pool);
+
+    SDL_LockMutex(pool->lock);
+    while(pool->finished < pool->numthreads) {
+        SDL_CondWait(pool->done, pool->lock);
+    }
+    SDL_UnlockMutex(pool->lock);
+}
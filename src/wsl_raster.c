@@ -0,0 +1,552 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * CPU sprite blitter. Sprites are drawn a row at a time in two steps: the
+ * texels under the row are fetched into a small buffer (nearest or bilinear,
+ * following the sprite's scale and angle back onto the texture), and then the
+ * whole buffer is color modulated and blended onto the framebuffer, four
+ * pixels at a time with SSE2.
+ *
+ * Textures are premultiplied, so the color/alpha mod works like
+ * SDL_SetTextureColorMod/SDL_SetTextureAlphaMod: each channel is scaled by
+ * (color * alpha), alpha by alpha.
+ *
+ * With a worker pool, wsl_raster_bin() only sets each sprite up and notes it
+ * in the RASTER_TILE tiles it touches. wsl_raster_flush() then hands the
+ * tiles out to the pool, each drawing its own sprites clipped to the tile.
+ */
+#define RASTER_SPAN 256 // Texels fetched per blend
+
+typedef struct {
+    uint32_t f[4]; // Factors for b, g, r, a, 0-255
+} RasterMod;
+
+static inline uint32_t raster_div255(uint32_t x) {
+    return (x + 128 + ((x + 128) >> 8)) >> 8;
+}
+
+static uint32_t raster_modulate(uint32_t p, const RasterMod *mod) {
+    return (raster_div255(((p >> 24) & 0xFF) * mod->f[3]) << 24) |
+        (raster_div255(((p >> 16) & 0xFF) * mod->f[2]) << 16) |
+        (raster_div255(((p >> 8) & 0xFF) * mod->f[1]) << 8) |
+        raster_div255((p & 0xFF) * mod->f[0]);
+}
+
+static uint32_t raster_blend_pixel(uint32_t d, uint32_t s,
+        SDL_BlendMode blend) {
+    /* One premultiplied, already modulated, pixel onto the framebuffer */
+    uint32_t inv, r, g, b, a;
+    switch(blend) {
+        case SDL_BLENDMODE_NONE:
+            return s;
+        case SDL_BLENDMODE_ADD:
+            r = ((d >> 16) & 0xFF) + ((s >> 16) & 0xFF);
+            g = ((d >> 8) & 0xFF) + ((s >> 8) & 0xFF);
+            b = (d & 0xFF) + (s & 0xFF);
+            return (d & 0xFF000000) | ((r > 255 ? 255 : r) << 16) |
+                ((g > 255 ? 255 : g) << 8) | (b > 255 ? 255 : b);
+        case SDL_BLENDMODE_MOD:
+            r = raster_div255(((d >> 16) & 0xFF) * ((s >> 16) & 0xFF));
+            g = raster_div255(((d >> 8) & 0xFF) * ((s >> 8) & 0xFF));
+            b = raster_div255((d & 0xFF) * (s & 0xFF));
+            return (d & 0xFF000000) | (r << 16) | (g << 8) | b;
+        case SDL_BLENDMODE_BLEND:
+        default:
+            inv = 255 - (s >> 24);
+            a = (s >> 24) + raster_div255((d >> 24) * inv);
+            r = ((s >> 16) & 0xFF) + raster_div255(((d >> 16) & 0xFF) * inv);
+            g = ((s >> 8) & 0xFF) + raster_div255(((d >> 8) & 0xFF) * inv);
+            b = (s & 0xFF) + raster_div255((d & 0xFF) * inv);
+            return (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+#if defined(__SSE2__)
+static inline __m128i raster_div255_epi16(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+static inline __m128i raster_alpha_epi16(__m128i x) {
+    /* Copy each pixel's alpha over its other three channels */
+    x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3,3,3,3));
+    return _mm_shufflehi_epi16(x, _MM_SHUFFLE(3,3,3,3));
+}
+#endif
+
+static void raster_blend_span(uint32_t *d, const uint32_t *s, int n,
+        const RasterMod *mod, SDL_BlendMode blend) {
+    /* Modulate n texels and blend them onto n framebuffer pixels */
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i modv = _mm_set_epi16(mod->f[3], mod->f[2], mod->f[1],
+            mod->f[0], mod->f[3], mod->f[2], mod->f[1], mod->f[0]);
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000);
+    __m128i sv, dv, slo, shi, dlo, dhi;
+    bool plain = (mod->f[0] == 255) && (mod->f[1] == 255) &&
+        (mod->f[2] == 255) && (mod->f[3] == 255);
+    for(; i + 4 <= n; i += 4) {
+        sv = _mm_loadu_si128((const __m128i*)(s + i));
+        // Nothing to do where all four are clear (sprite borders, mostly)
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(sv, amask),
+                        zero)) == 0xFFFF && blend != SDL_BLENDMODE_NONE) {
+            continue;
+        }
+        // Or all four opaque, blending is just a copy
+        if(plain && blend == SDL_BLENDMODE_BLEND &&
+                _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(sv, amask),
+                        amask)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i*)(d + i), sv);
+            continue;
+        }
+        dv = _mm_loadu_si128((const __m128i*)(d + i));
+        slo = _mm_unpacklo_epi8(sv, zero);
+        shi = _mm_unpackhi_epi8(sv, zero);
+        if(!plain) {
+            slo = raster_div255_epi16(_mm_mullo_epi16(slo, modv));
+            shi = raster_div255_epi16(_mm_mullo_epi16(shi, modv));
+        }
+        switch(blend) {
+            case SDL_BLENDMODE_NONE:
+                dv = _mm_packus_epi16(slo, shi);
+                break;
+            case SDL_BLENDMODE_ADD:
+                dv = _mm_or_si128(_mm_and_si128(dv, amask),
+                        _mm_andnot_si128(amask, _mm_adds_epu8(dv,
+                                _mm_packus_epi16(slo, shi))));
+                break;
+            case SDL_BLENDMODE_MOD:
+                dlo = raster_div255_epi16(_mm_mullo_epi16(
+                            _mm_unpacklo_epi8(dv, zero), slo));
+                dhi = raster_div255_epi16(_mm_mullo_epi16(
+                            _mm_unpackhi_epi8(dv, zero), shi));
+                dv = _mm_or_si128(_mm_and_si128(dv, amask),
+                        _mm_andnot_si128(amask, _mm_packus_epi16(dlo, dhi)));
+                break;
+            case SDL_BLENDMODE_BLEND:
+            default:
+                dlo = raster_div255_epi16(_mm_mullo_epi16(
+                            _mm_unpacklo_epi8(dv, zero),
+                            _mm_sub_epi16(full, raster_alpha_epi16(slo))));
+                dhi = raster_div255_epi16(_mm_mullo_epi16(
+                            _mm_unpackhi_epi8(dv, zero),
+                            _mm_sub_epi16(full, raster_alpha_epi16(shi))));
+                dv = _mm_packus_epi16(_mm_add_epi16(dlo, slo),
+                        _mm_add_epi16(dhi, shi));
+                break;
+        }
+        _mm_storeu_si128((__m128i*)(d + i), dv);
+    }
+#endif
+    for(; i < n; i++) {
+        if(!(s[i] >> 24) && blend != SDL_BLENDMODE_NONE) continue;
+        d[i] = raster_blend_pixel(d[i], raster_modulate(s[i], mod), blend);
+    }
+}
+
+static inline uint32_t raster_lerp(uint32_t a, uint32_t b, uint32_t f) {
+    /* a to b by f/256, two channels at a time */
+    uint32_t rb = (((a & 0x00FF00FF) * (256 - f)) +
+            ((b & 0x00FF00FF) * f)) >> 8;
+    uint32_t ag = ((((a >> 8) & 0x00FF00FF) * (256 - f)) +
+            (((b >> 8) & 0x00FF00FF) * f)) >> 8;
+    return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+static void raster_fetch_nearest(const WSL_Texture *t, const SDL_Rect *src,
+        uint32_t *out, int n, int32_t u, int32_t v, int32_t du, int32_t dv) {
+    /* n texels along a row, u/v in 16.16 texels, clamped to the sprite */
+    int x, iu, iv;
+    int umax = src->x + src->w - 1, vmax = src->y + src->h - 1;
+    for(x = 0; x < n; x++) {
+        iu = u >> 16;
+        iv = v >> 16;
+        iu = iu < src->x ? src->x : (iu > umax ? umax : iu);
+        iv = iv < src->y ? src->y : (iv > vmax ? vmax : iv);
+        out[x] = t->pixels[(iv * t->w) + iu];
+        u += du;
+        v += dv;
+    }
+}
+
+static void raster_fetch_bilinear(const WSL_Texture *t, const SDL_Rect *src,
+        uint32_t *out, int n, int32_t u, int32_t v, int32_t du, int32_t dv) {
+    /* Same, filtered between the four nearest texels (centers on the
+     * halves, so the sample point is shifted back half a texel) */
+    int x, u0, v0, u1, v1;
+    uint32_t fu, fv, top, bottom;
+    int umax = src->x + src->w - 1, vmax = src->y + src->h - 1;
+    const uint32_t *row0, *row1;
+    u -= 0x8000;
+    v -= 0x8000;
+    for(x = 0; x < n; x++) {
+        u0 = u >> 16;
+        v0 = v >> 16;
+        fu = (u >> 8) & 0xFF;
+        fv = (v >> 8) & 0xFF;
+        u1 = u0 + 1;
+        v1 = v0 + 1;
+        u0 = u0 < src->x ? src->x : (u0 > umax ? umax : u0);
+        u1 = u1 < src->x ? src->x : (u1 > umax ? umax : u1);
+        v0 = v0 < src->y ? src->y : (v0 > vmax ? vmax : v0);
+        v1 = v1 < src->y ? src->y : (v1 > vmax ? vmax : v1);
+        row0 = t->pixels + (v0 * t->w);
+        row1 = t->pixels + (v1 * t->w);
+        top = raster_lerp(row0[u0], row0[u1], fu);
+        bottom = raster_lerp(row1[u0], row1[u1], fu);
+        out[x] = raster_lerp(top, bottom, fv);
+        u += du;
+        v += dv;
+    }
+}
+
+static bool raster_span(float l0, float dl, float size, int *x0, int *x1) {
+    /* Narrow [x0,x1) down to where l0 + dl*x stays within [0,size) */
+    float lo, hi, tmp;
+    if(dl > -1e-6f && dl < 1e-6f) {
+        return (l0 >= 0) && (l0 < size);
+    }
+    lo = -l0 / dl;
+    hi = (size - l0) / dl;
+    if(lo > hi) {
+        tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+    if(ceilf(lo) > *x0) *x0 = (int)ceilf(lo);
+    if(ceilf(hi) < *x1) *x1 = (int)ceilf(hi);
+    return *x0 < *x1;
+}
+
+static bool raster_setup(WSL_Raster *raster, WSL_RasterSprite *sprite,
+        WSL_Texture *t, const SDL_Rect *src, const SDL_Rect *dst,
+        double angle, SDL_BlendMode blend, SDL_Color color) {
+    /*
+     * Fill in sprite, and work out the screen area it can touch. Returns
+     * false if there's nothing to draw.
+     */
+    float hw, hh, cx, cy, px, py, s = 0, c = 1;
+    float corner[4][2];
+    float minx, maxx, miny, maxy;
+    int i, x0, x1, y0, y1;
+
+    if(!raster || !t || !t->pixels || !dst) return false;
+    sprite->src = src ? *src : (SDL_Rect){0, 0, t->w, t->h};
+    if(dst->w <= 0 || dst->h <= 0 || sprite->src.w <= 0 ||
+            sprite->src.h <= 0) {
+        return false;
+    }
+    if(!color.a && blend != SDL_BLENDMODE_NONE) return false;
+
+    hw = dst->w * 0.5f;
+    hh = dst->h * 0.5f;
+    cx = dst->x + hw;
+    cy = dst->y + hh;
+    if(angle) fast_sincosf((float)(angle * (M_PI / 180.0)), &s, &c);
+
+    // Screen area the sprite can touch
+    corner[0][0] = -hw; corner[0][1] = -hh;
+    corner[1][0] = hw;  corner[1][1] = -hh;
+    corner[2][0] = hw;  corner[2][1] = hh;
+    corner[3][0] = -hw; corner[3][1] = hh;
+    minx = maxx = cx + (corner[0][0] * c) - (corner[0][1] * s);
+    miny = maxy = cy + (corner[0][0] * s) + (corner[0][1] * c);
+    for(i = 1; i < 4; i++) {
+        px = cx + (corner[i][0] * c) - (corner[i][1] * s);
+        py = cy + (corner[i][0] * s) + (corner[i][1] * c);
+        if(px < minx) minx = px;
+        if(px > maxx) maxx = px;
+        if(py < miny) miny = py;
+        if(py > maxy) maxy = py;
+    }
+    x0 = (int)floorf(minx);
+    x1 = (int)ceilf(maxx);
+    y0 = (int)floorf(miny);
+    y1 = (int)ceilf(maxy);
+    if(x0 < 0) x0 = 0;
+    if(y0 < 0) y0 = 0;
+    if(x1 > raster->w) x1 = raster->w;
+    if(y1 > raster->h) y1 = raster->h;
+    if(x0 >= x1 || y0 >= y1) return false;
+
+    sprite->tex = t;
+    sprite->dst = *dst;
+    sprite->bounds = (SDL_Rect){x0, y0, x1 - x0, y1 - y0};
+    sprite->s = s;
+    sprite->c = c;
+    sprite->blend = blend;
+    sprite->color = color;
+    return true;
+}
+
+static void raster_draw(WSL_Raster *raster, const WSL_RasterSprite *sprite,
+        const SDL_Rect *clip) {
+    /* Draw the part of a set up sprite that's inside clip */
+    uint32_t texels[RASTER_SPAN];
+    const SDL_Rect *src = &sprite->src;
+    const SDL_Rect *dst = &sprite->dst;
+    RasterMod mod;
+    float hw, hh, cx, cy, sx, sy, px, py, lx, ly;
+    float s = sprite->s, c = sprite->c;
+    int32_t u, v, du, dv;
+    int x0, x1, y0, y1, y, x, n, xs, xe, bx;
+    bool filter;
+    void (*fetch)(const WSL_Texture*, const SDL_Rect*, uint32_t*, int,
+            int32_t, int32_t, int32_t, int32_t);
+
+    x0 = sprite->bounds.x > clip->x ? sprite->bounds.x : clip->x;
+    y0 = sprite->bounds.y > clip->y ? sprite->bounds.y : clip->y;
+    x1 = sprite->bounds.x + sprite->bounds.w;
+    y1 = sprite->bounds.y + sprite->bounds.h;
+    if(x1 > clip->x + clip->w) x1 = clip->x + clip->w;
+    if(y1 > clip->y + clip->h) y1 = clip->y + clip->h;
+    if(x0 >= x1 || y0 >= y1) return;
+
+    mod.f[0] = raster_div255((uint32_t)sprite->color.b * sprite->color.a);
+    mod.f[1] = raster_div255((uint32_t)sprite->color.g * sprite->color.a);
+    mod.f[2] = raster_div255((uint32_t)sprite->color.r * sprite->color.a);
+    mod.f[3] = sprite->color.a;
+
+    hw = dst->w * 0.5f;
+    hh = dst->h * 0.5f;
+    cx = dst->x + hw;
+    cy = dst->y + hh;
+    sx = (float)src->w / dst->w; // Texels per pixel
+    sy = (float)src->h / dst->h;
+
+    // Straight 1:1 copies don't need filtering
+    filter = raster->bilinear && (s != 0 || c != 1 || dst->w != src->w ||
+            dst->h != src->h);
+    fetch = filter ? &raster_fetch_bilinear : &raster_fetch_nearest;
+
+    du = (int32_t)(c * sx * 65536.0f);
+    dv = (int32_t)(-s * sy * 65536.0f);
+    bx = sprite->bounds.x;
+    for(y = y0; y < y1; y++) {
+        // Where the first pixel center of the row lands on the sprite,
+        // measured in dst pixels from its top left corner. Always worked out
+        // from the left of the sprite's bounds, not the clip, so a sprite
+        // split over tiles steps through exactly the same texels.
+        px = bx + 0.5f - cx;
+        py = y + 0.5f - cy;
+        lx = (px * c) + (py * s) + hw;
+        ly = -(px * s) + (py * c) + hh;
+        xs = 0;
+        xe = sprite->bounds.w;
+        if(!raster_span(lx, c, dst->w, &xs, &xe)) continue;
+        if(!raster_span(ly, -s, dst->h, &xs, &xe)) continue;
+        u = (int32_t)((src->x + ((lx + (c * xs)) * sx)) * 65536.0f);
+        v = (int32_t)((src->y + ((ly - (s * xs)) * sy)) * 65536.0f);
+        x = xs > x0 - bx ? xs : x0 - bx;
+        if(xe > x1 - bx) xe = x1 - bx;
+        u += du * (x - xs);
+        v += dv * (x - xs);
+        for(; x < xe; x += n) {
+            n = (xe - x) < RASTER_SPAN ? (xe - x) : RASTER_SPAN;
+            fetch(sprite->tex, src, texels, n, u, v, du, dv);
+            raster_blend_span(raster->pixels + (y * raster->pitch) + bx + x,
+                    texels, n, &mod, sprite->blend);
+            u += du * n;
+            v += dv * n;
+        }
+    }
+}
+
+static void raster_draw_tile(void *data, int index) {
+    /* Pool job: draw everything binned to one tile, in order */
+    WSL_Raster *raster = data;
+    WSL_RasterTile *tile = &raster->tiles[index];
+    SDL_Rect clip;
+    int i;
+    clip.x = (index % raster->tilesw) * RASTER_TILE;
+    clip.y = (index / raster->tilesw) * RASTER_TILE;
+    clip.w = RASTER_TILE;
+    clip.h = RASTER_TILE;
+    for(i = 0; i < tile->count; i++) {
+        raster_draw(raster, &raster->sprites[tile->sprites[i]], &clip);
+    }
+    tile->count = 0;
+}
+
+static bool raster_tile_add(WSL_RasterTile *tile, int sprite) {
+    int *grown = NULL;
+    int max;
+    if(tile->count == tile->max) {
+        max = tile->max ? tile->max * 2 : 64;
+        grown = realloc(tile->sprites, sizeof(int) * max);
+        if(!grown) return false;
+        tile->sprites = grown;
+        tile->max = max;
+    }
+    tile->sprites[tile->count++] = sprite;
+    return true;
+}
+
+WSL_Raster* wsl_raster_create(int w, int h, WSL_Stats *stats) {
+    WSL_Raster *raster = malloc(sizeof(WSL_Raster));
+    if(!raster) return NULL;
+    raster->surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32,
+            SDL_PIXELFORMAT_ARGB8888);
+    raster->tilesw = (w + RASTER_TILE - 1) / RASTER_TILE;
+    raster->tilesh = (h + RASTER_TILE - 1) / RASTER_TILE;
+    raster->tiles = calloc(raster->tilesw * raster->tilesh,
+            sizeof(WSL_RasterTile));
+    if(!raster->surface || !raster->tiles) {
+        printf("Unable to create the framebuffer! SDL Error: %s\n",
+                SDL_GetError());
+        if(raster->surface) SDL_FreeSurface(raster->surface);
+        free(raster->tiles);
+        free(raster);
+        return NULL;
+    }
+    // Copied straight onto the window, not blended
+    SDL_SetSurfaceBlendMode(raster->surface, SDL_BLENDMODE_NONE);
+    raster->pixels = raster->surface->pixels;
+    raster->pitch = raster->surface->pitch / 4;
+    raster->w = w;
+    raster->h = h;
+    raster->bilinear = true; // Like SDL_HINT_RENDER_SCALE_QUALITY "1"
+    raster->stats = stats;
+    raster->fill = 0;
+    raster->pool = NULL;
+    raster->sprites = NULL;
+    raster->numsprites = 0;
+    raster->maxsprites = 0;
+    return raster;
+}
+
+void wsl_raster_destroy(WSL_Raster *raster) {
+    int i;
+    if(!raster) return;
+    for(i = 0; i < raster->tilesw * raster->tilesh; i++) {
+        free(raster->tiles[i].sprites);
+    }
+    free(raster->tiles);
+    free(raster->sprites);
+    SDL_FreeSurface(raster->surface);
+    free(raster);
+}
+
+static void raster_clear_rows(void *data, int index) {
+    /* Pool job: clear one row of tiles to raster->fill */
+    WSL_Raster *raster = data;
+    int x, y, y1 = (index + 1) * RASTER_TILE;
+    if(y1 > raster->h) y1 = raster->h;
+    for(y = index * RASTER_TILE; y < y1; y++) {
+        for(x = 0; x < raster->w; x++) {
+            raster->pixels[(y * raster->pitch) + x] = raster->fill;
+        }
+    }
+}
+
+void wsl_raster_clear(WSL_Raster *raster, SDL_Color color) {
+    if(!raster) return;
+    raster->fill = ((uint32_t)color.a << 24) | ((uint32_t)color.r << 16) |
+        ((uint32_t)color.g << 8) | color.b;
+    wsl_pool_run(raster->pool, &raster_clear_rows, raster, raster->tilesh);
+}
+
+void wsl_raster_sprite(WSL_Raster *raster, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color) {
+    /*
+     * Draw part of a texture (all of it if src is NULL) into dst, tinted by
+     * color and turned "angle" degrees clockwise around the middle of dst,
+     * the same as wsl_batch_sprite would have SDL draw it.
+     */
+    WSL_RasterSprite sprite;
+    if(!raster_setup(raster, &sprite, t, src, dst, angle, blend, color)) {
+        return;
+    }
+    if(raster->stats) raster->stats->sprites += 1;
+    raster_draw(raster, &sprite, &sprite.bounds);
+}
+
+void wsl_raster_bin(WSL_Raster *raster, WSL_Texture *t, const SDL_Rect *src,
+        const SDL_Rect *dst, double angle, SDL_BlendMode blend,
+        SDL_Color color) {
+    /*
+     * Same as wsl_raster_sprite, but only drops the sprite into the bins of
+     * the tiles it touches, wsl_raster_flush() draws them. Without a pool
+     * it's just drawn straight away.
+     */
+    WSL_RasterSprite *grown = NULL;
+    WSL_RasterSprite *sprite = NULL;
+    int tx, ty, tx0, tx1, ty0, ty1, max;
+    if(!raster) return;
+    if(!raster->pool) {
+        wsl_raster_sprite(raster, t, src, dst, angle, blend, color);
+        return;
+    }
+    if(raster->numsprites == raster->maxsprites) {
+        max = raster->maxsprites ? raster->maxsprites * 2 : 1024;
+        grown = realloc(raster->sprites, sizeof(WSL_RasterSprite) * max);
+        if(!grown) return;
+        raster->sprites = grown;
+        raster->maxsprites = max;
+    }
+    sprite = &raster->sprites[raster->numsprites];
+    if(!raster_setup(raster, sprite, t, src, dst, angle, blend, color)) {
+        return;
+    }
+    if(raster->stats) raster->stats->sprites += 1;
+
+    tx0 = sprite->bounds.x / RASTER_TILE;
+    ty0 = sprite->bounds.y / RASTER_TILE;
+    tx1 = (sprite->bounds.x + sprite->bounds.w - 1) / RASTER_TILE;
+    ty1 = (sprite->bounds.y + sprite->bounds.h - 1) / RASTER_TILE;
+    for(ty = ty0; ty <= ty1; ty++) {
+        for(tx = tx0; tx <= tx1; tx++) {
+            raster_tile_add(&raster->tiles[(ty * raster->tilesw) + tx],
+                    raster->numsprites);
+        }
+    }
+    raster->numsprites += 1;
+}
+
+void wsl_raster_flush(WSL_Raster *raster) {
+    /*
+     * Draw the binned sprites, a tile per job. Tiles don't overlap, and each
+     * one draws its sprites in the order they were binned, so the frame comes
+     * out the same as drawing them one after the other.
+     */
+    if(!raster || !raster->numsprites) return;
+    wsl_pool_run(raster->pool, &raster_draw_tile, raster,
+            raster->tilesw * raster->tilesh);
+    raster->numsprites = 0;
+}
+
+void wsl_raster_present(WSL_Raster *raster, SDL_Window *window) {
+    /* Copy the frame onto the window (there might not be one, headless) */
+    SDL_Surface *screen = NULL;
+    if(!raster || !window) return;
+    screen = SDL_GetWindowSurface(window);
+    if(!screen) return;
+    SDL_BlitSurface(raster->surface, NULL, screen, NULL);
+    SDL_UpdateWindowSurface(window);
+}
@@ -0,0 +1,234 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+/*
+ * Render commands. Everything drawn in a frame is written into one array as
+ * a small command (texture, rects, angle, color) with a 16 bit sort key:
+ *
+ *   layer (4 bits) | blend mode (4 bits) | texture slot (8 bits)
+ *
+ * The keys (with the command's index underneath) are radix sorted, and the
+ * commands handed to the batcher in that order. The sort is
+ * stable, so things on the same layer with the same texture still draw in
+ * the order they were queued. On RENDER_ORDERED layers the key is just the
+ * layer, so everything on them draws in the order it was queued: HUD text
+ * comes from the glyph atlas and the text cache, different textures, and
+ * grouping those would put one string over another out of turn. Once a
+ * frame's commands are written nothing else touches the game state, so this
+ * is also where a render thread could take over.
+ */
+#define RENDER_SLOT_BITS 8
+#define RENDER_MAX_SLOTS (1 << RENDER_SLOT_BITS)
+#define RENDER_ORDERED(layer) ((layer) >= RL_HUD)
+
+static int render_blend_bits(SDL_BlendMode blend) {
+    switch(blend) {
+        case SDL_BLENDMODE_NONE: return 0;
+        case SDL_BLENDMODE_ADD: return 2;
+        case SDL_BLENDMODE_MOD: return 3;
+        case SDL_BLENDMODE_BLEND:
+        default: return 1;
+    }
+}
+
+static SDL_BlendMode render_blend_mode(int bits) {
+    switch(bits) {
+        case 0: return SDL_BLENDMODE_NONE;
+        case 2: return SDL_BLENDMODE_ADD;
+        case 3: return SDL_BLENDMODE_MOD;
+        default: return SDL_BLENDMODE_BLEND;
+    }
+}
+
+static int render_texture_slot(WSL_RenderQueue *queue, WSL_Texture *t) {
+    /* Small number standing in for the texture in the sort key. A frame only
+     * uses a handful of textures, anything past the last slot shares it (the
+     * batcher still switches textures correctly, it just isn't grouped). */
+    int i;
+    for(i = 0; i < queue->numtextures; i++) {
+        if(queue->textures[i] == t) return i;
+    }
+    if(queue->numtextures < RENDER_MAX_SLOTS) {
+        queue->textures[queue->numtextures] = t;
+        return queue->numtextures++;
+    }
+    return RENDER_MAX_SLOTS - 1;
+}
+
+WSL_RenderQueue* wsl_render_queue_create(void) {
+    WSL_RenderQueue *queue = calloc(1, sizeof(WSL_RenderQueue));
+    if(!queue) return NULL;
+    queue->max = 1024;
+    queue->cmds = malloc(sizeof(WSL_RenderCmd) * queue->max);
+    queue->order = malloc(sizeof(uint64_t) * queue->max * 2);
+    queue->textures = malloc(sizeof(WSL_Texture*) * RENDER_MAX_SLOTS);
+    if(!queue->cmds || !queue->order || !queue->textures) {
+        wsl_render_queue_destroy(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+void wsl_render_queue_destroy(WSL_RenderQueue *queue) {
+    int i;
+    if(!queue) return;
+    free(queue->cmds);
+    free(queue->order);
+    free(queue->textures);
+    for(i = 0; i < queue->maxscratch; i++) {
+        destroy_wsl_texture(queue->scratch[i]);
+    }
+    free(queue->scratch);
+    free(queue);
+}
+
+WSL_Texture* wsl_render_queue_scratch(WSL_RenderQueue *queue,
+        SDL_Renderer *renderer) {
+    /*
+     * A texture for something drawn once and not kept anywhere else, like
+     * text that missed the atlas and the cache. Load it and queue it like
+     * any other; it's left alone until the frame's been drawn, and then
+     * handed out again (and reloaded) next frame.
+     */
+    WSL_Texture **grown = NULL;
+    int max;
+    if(!queue) return NULL;
+    if(queue->numscratch == queue->maxscratch) {
+        max = queue->maxscratch ? queue->maxscratch * 2 : 8;
+        grown = realloc(queue->scratch, sizeof(WSL_Texture*) * max);
+        if(!grown) return NULL;
+        queue->scratch = grown;
+        for(; queue->maxscratch < max; queue->maxscratch++) {
+            queue->scratch[queue->maxscratch] = create_wsl_texture(renderer);
+        }
+    }
+    return queue->scratch[queue->numscratch++];
+}
+
+void wsl_render_sprite(WSL_RenderQueue *queue, int layer, WSL_Texture *t,
+        SDL_BlendMode blend, const SDL_Rect *src, const SDL_Rect *dst,
+        double angle, SDL_Color color) {
+    /*
+     * Queue part of a texture (all of it if src is NULL) to be drawn into dst
+     * on a layer, tinted by color and turned "angle" degrees clockwise around
+     * the middle of dst.
+     */
+    WSL_RenderCmd *cmd = NULL;
+    WSL_RenderCmd *grown = NULL;
+    uint64_t *order = NULL;
+    if(!queue || !wsl_texture_loaded(t)) return;
+    if(queue->count == queue->max) {
+        grown = realloc(queue->cmds, sizeof(WSL_RenderCmd) * queue->max * 2);
+        if(!grown) return;
+        queue->cmds = grown;
+        order = realloc(queue->order, sizeof(uint64_t) * queue->max * 4);
+        if(!order) return;
+        queue->order = order;
+        queue->max *= 2;
+    }
+    cmd = &queue->cmds[queue->count++];
+    cmd->key = (layer & 0xF) << 12;
+    if(!RENDER_ORDERED(layer)) {
+        cmd->key |= (render_blend_bits(blend) << 8) |
+            render_texture_slot(queue, t);
+    }
+    cmd->blend = render_blend_bits(blend);
+    cmd->tex = t;
+    if(src) {
+        cmd->src = *src;
+    } else {
+        cmd->src = (SDL_Rect){0, 0, t->w, t->h};
+    }
+    cmd->dst = *dst;
+    cmd->angle = angle;
+    cmd->color = color;
+}
+
+void wsl_render_queue_sort(WSL_RenderQueue *queue) {
+    /*
+     * Stable LSD radix sort, one pass per key byte. Only key/index pairs get
+     * moved around (the first half of "order", the second half is scratch),
+     * the commands themselves stay put.
+     */
+    uint64_t *src = queue->order, *dst = queue->order + queue->max, *tmp = NULL;
+    int count[256];
+    int pass, shift, i, sum, b;
+    for(i = 0; i < queue->count; i++) {
+        src[i] = ((uint64_t)queue->cmds[i].key << 32) | (uint32_t)i;
+    }
+    for(pass = 0; pass < 2; pass++) {
+        shift = 32 + (pass * 8);
+        memset(count, 0, sizeof(count));
+        for(i = 0; i < queue->count; i++) {
+            count[(src[i] >> shift) & 0xFF] += 1;
+        }
+        sum = 0;
+        for(b = 0; b < 256; b++) {
+            i = count[b];
+            count[b] = sum;
+            sum += i;
+        }
+        for(i = 0; i < queue->count; i++) {
+            b = (src[i] >> shift) & 0xFF;
+            dst[count[b]++] = src[i];
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    // Two passes, so the sorted pairs ended up back at the front
+}
+
+void wsl_render_queue_submit(WSL_RenderQueue *queue, WSL_Batch *batch) {
+    /* Sort the frame's commands, draw them all, and start the next frame */
+    WSL_RenderCmd *cmd = NULL;
+    int i;
+    if(!queue) return;
+    wsl_render_queue_sort(queue);
+    for(i = 0; i < queue->count; i++) {
+        cmd = &queue->cmds[(uint32_t)queue->order[i]];
+        wsl_batch_sprite(batch, cmd->tex, &cmd->src, &cmd->dst, cmd->angle,
+                render_blend_mode(cmd->blend), cmd->color);
+    }
+    wsl_batch_flush(batch);
+    queue->count = 0;
+    queue->numtextures = 0;
+    queue->numscratch = 0;
+}
+
+void wsl_render_queue_raster(WSL_RenderQueue *queue, WSL_Raster *raster) {
+    /* Same as wsl_render_queue_submit, drawn on the CPU into raster */
+    WSL_RenderCmd *cmd = NULL;
+    int i;
+    if(!queue || !raster) return;
+    wsl_render_queue_sort(queue);
+    for(i = 0; i < queue->count; i++) {
+        cmd = &queue->cmds[(uint32_t)queue->order[i]];
+        wsl_raster_bin(raster, cmd->tex, &cmd->src, &cmd->dst, cmd->angle,
+                render_blend_mode(cmd->blend), cmd->color);
+    }
+    wsl_raster_flush(raster);
+    if(raster->stats && queue->count) raster->stats->drawcalls += 1;
+    queue->count = 0;
+    queue->numtextures = 0;
+    queue->numscratch = 0;
+}
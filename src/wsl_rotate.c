@@ -0,0 +1,215 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+*
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+#define ROT_CACHE_WIDTH 2048 // Frames are packed into rows this wide
+
+static uint32_t rot_sample(const uint32_t *px, int pitch, const SDL_Rect *src,
+        float sx, float sy) {
+    /*
+     * Bilinear sample of the sprite at sx,sy (pixel centers on the halves),
+     * anything outside the sprite counts as clear. The four taps are
+     * weighted with their alpha so clear pixels don't bleed a dark fringe
+     * into the edges.
+     */
+    int x0 = (int)floorf(sx - 0.5f), y0 = (int)floorf(sy - 0.5f);
+    float fx = (sx - 0.5f) - x0, fy = (sy - 0.5f) - y0;
+    float w[4] = {(1 - fx) * (1 - fy), fx * (1 - fy), (1 - fx) * fy, fx * fy};
+    float a = 0, r = 0, g = 0, b = 0, wa;
+    uint32_t p;
+    int i, x, y;
+    for(i = 0; i < 4; i++) {
+        x = x0 + (i & 1);
+        y = y0 + (i >> 1);
+        if(x < 0 || y < 0 || x >= src->w || y >= src->h) continue;
+        p = px[(src->y + y) * pitch + src->x + x];
+        wa = w[i] * (p >> 24);
+        a += wa;
+        r += wa * ((p >> 16) & 0xFF);
+        g += wa * ((p >> 8) & 0xFF);
+        b += wa * (p & 0xFF);
+    }
+    if(a < 1.0f) return 0;
+    return ((uint32_t)(a + 0.5f) << 24) | ((uint32_t)(r / a + 0.5f) << 16) |
+        ((uint32_t)(g / a + 0.5f) << 8) | (uint32_t)(b / a + 0.5f);
+}
+
+static void rot_cache_draw_frame(SDL_Surface *sheet, SDL_Surface *cache,
+        const WSL_RotSprite *sprite, int frame) {
+    /* Turn the sprite frame * 360/ROT_CACHE_ANGLES degrees clockwise into
+     * its square in the cache, around the middle of both */
+    const uint32_t *src = sheet->pixels;
+    uint32_t *dst = cache->pixels;
+    int srcpitch = sheet->pitch / 4, dstpitch = cache->pitch / 4;
+    int fx = (frame % sprite->cols) * sprite->size;
+    int fy = sprite->y + (frame / sprite->cols) * sprite->size;
+    float s, c, dx, dy;
+    float half = sprite->size * 0.5f;
+    float hw = sprite->src.w * 0.5f, hh = sprite->src.h * 0.5f;
+    int x, y;
+    // Only runs at load, plain libm is fine
+    s = sinf((float)(frame * (2 * M_PI / ROT_CACHE_ANGLES)));
+    c = cosf((float)(frame * (2 * M_PI / ROT_CACHE_ANGLES)));
+    for(y = 0; y < sprite->size; y++) {
+        for(x = 0; x < sprite->size; x++) {
+            // Back from the turned frame to where it came from on the sprite
+            dx = x + 0.5f - half;
+            dy = y + 0.5f - half;
+            dst[(fy + y) * dstpitch + fx + x] = rot_sample(src, srcpitch,
+                    &sprite->src, hw + (dx * c) + (dy * s),
+                    hh - (dx * s) + (dy * c));
+        }
+    }
+}
+
+WSL_RotCache* wsl_rot_cache_create(SDL_Renderer *renderer, char *path,
+        const SDL_Rect *sprites, int count) {
+    /*
+     * Load the spritesheet at path and draw each of the sprites turned to
+     * ROT_CACHE_ANGLES steps all the way around, into one texture. Every
+     * sprite gets a block of square frames, as many to a row as will fit.
+     */
+    WSL_RotCache *cache = NULL;
+    WSL_RotSprite *sprite = NULL;
+    SDL_Surface *loaded = NULL;
+    SDL_Surface *sheet = NULL;
+    SDL_Surface *frames = NULL;
+    uint32_t *px = NULL;
+    int i, j, y = 0;
+
+    if(!renderer || !sprites || count > ROT_CACHE_MAX_SPRITES) return NULL;
+    loaded = IMG_Load(path);
+    if(!loaded) {
+        printf("Unable to load image %s! SDL_image Error: %s\n",
+                path, IMG_GetError());
+        return NULL;
+    }
+    sheet = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if(!sheet) {
+        printf("Unable to convert %s! SDL Error: %s\n", path, SDL_GetError());
+        return NULL;
+    }
+    // Same color key wsl_texture_load uses, as real transparency
+    px = sheet->pixels;
+    for(i = 0; i < (sheet->pitch / 4) * sheet->h; i++) {
+        if(px[i] == 0xFF00FFFF) px[i] = 0;
+    }
+
+    cache = malloc(sizeof(WSL_RotCache));
+    if(!cache) {
+        SDL_FreeSurface(sheet);
+        return NULL;
+    }
+    cache->tex = NULL;
+    cache->count = count;
+    for(i = 0; i < count; i++) {
+        sprite = &cache->sprites[i];
+        sprite->src = sprites[i];
+        sprite->size = (int)ceilf(sqrtf((float)(sprites[i].w * sprites[i].w +
+                        sprites[i].h * sprites[i].h))) + 2;
+        sprite->cols = ROT_CACHE_WIDTH / sprite->size;
+        sprite->y = y;
+        y += sprite->size * ((ROT_CACHE_ANGLES + sprite->cols - 1) /
+                sprite->cols);
+    }
+
+    frames = SDL_CreateRGBSurfaceWithFormat(0, ROT_CACHE_WIDTH, y, 32,
+            SDL_PIXELFORMAT_ARGB8888);
+    if(!frames) {
+        printf("Unable to create rotation cache surface! SDL Error: %s\n",
+                SDL_GetError());
+    } else {
+        SDL_FillRect(frames, NULL, 0);
+        for(i = 0; i < count; i++) {
+            for(j = 0; j < ROT_CACHE_ANGLES; j++) {
+                rot_cache_draw_frame(sheet, frames, &cache->sprites[i], j);
+            }
+        }
+        cache->tex = create_wsl_texture(renderer);
+        if(!wsl_texture_from_surface(cache->tex, frames)) {
+            printf("Unable to create rotation cache texture! SDL Error: %s\n",
+                    SDL_GetError());
+        }
+        SDL_FreeSurface(frames);
+    }
+    SDL_FreeSurface(sheet);
+
+    if(!wsl_texture_loaded(cache->tex)) {
+        wsl_rot_cache_destroy(cache);
+        cache = NULL;
+    }
+    return cache;
+}
+
+void wsl_rot_cache_destroy(WSL_RotCache *cache) {
+    if(!cache) return;
+    destroy_wsl_texture(cache->tex);
+    free(cache);
+}
+
+bool wsl_rot_cache_render(WSL_RotCache *cache, WSL_RenderQueue *queue,
+        int layer, const SDL_Rect *src, const SDL_Rect *dst, double angle,
+        SDL_Color color) {
+    /*
+     * Queue the cached frame nearest to angle, unturned, in place of the
+     * sprite src drawn turned into dst. Returns false if src isn't cached, so
+     * the caller can draw it the normal way.
+     */
+    WSL_RotSprite *sprite = NULL;
+    SDL_Rect framesrc, framedst;
+    float scale;
+    int i, frame;
+    if(!cache) return false;
+    for(i = 0; i < cache->count; i++) {
+        if((cache->sprites[i].src.x == src->x) &&
+                (cache->sprites[i].src.y == src->y) &&
+                (cache->sprites[i].src.w == src->w) &&
+                (cache->sprites[i].src.h == src->h)) {
+            sprite = &cache->sprites[i];
+            break;
+        }
+    }
+    if(!sprite) return false;
+
+    frame = (int)floor(angle * (ROT_CACHE_ANGLES / 360.0) + 0.5);
+    frame %= ROT_CACHE_ANGLES;
+    if(frame < 0) frame += ROT_CACHE_ANGLES;
+    framesrc.x = (frame % sprite->cols) * sprite->size;
+    framesrc.y = sprite->y + (frame / sprite->cols) * sprite->size;
+    framesrc.w = framesrc.h = sprite->size;
+
+    // Same middle as dst, the frame is scaled the way the sprite would be
+    scale = (float)dst->w / src->w;
+    framedst.w = framedst.h = (int)(sprite->size * scale + 0.5f);
+    framedst.x = dst->x + (dst->w - framedst.w) / 2;
+    framedst.y = dst->y + (dst->h - framedst.h) / 2;
+    wsl_render_sprite(queue, layer, cache->tex, SDL_BLENDMODE_BLEND,
+            &framesrc, &framedst, 0, color);
+    return true;
+}
+
+bool wsl_renderer_is_software(SDL_Renderer *renderer) {
+    /* True if SDL fell back to drawing on the CPU */
+    SDL_RendererInfo info;
+    if(!renderer || SDL_GetRendererInfo(renderer, &info) != 0) return false;
+    return (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+}
@@ -23,21 +23,28 @@
 /*****
  * WSL_App
  *****/
-WSL_App* wsl_init_sdl(void) {
+WSL_App* wsl_init_sdl(int backend) {
+    /*
+     * Start SDL and load everything. RB_HEADLESS skips the window, renderer,
+     * sound and assets altogether, none of which the simulation needs, and
+     * leaves them all NULL.
+     */
     bool success = true;
+    bool headless = (backend == RB_HEADLESS);
     int imgflags = IMG_INIT_PNG;
-    int i = 0;
 
-    WSL_App *app = malloc(sizeof(WSL_App));
+    WSL_App *app = calloc(1, sizeof(WSL_App));
+    if(!app) return NULL;
+    app->backend = backend; // Everything else starts out zeroed
 
     // Initialize SDL
-    if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
+    if(SDL_Init(headless ? 0 : (SDL_INIT_VIDEO | SDL_INIT_AUDIO)) < 0) {
         printf("SDL could not initialize. SDL Error: %s\n", SDL_GetError());
         success = false;
     }
 
     // Create the window
-    if(success) {
+    if(success && !headless) {
         app->window = SDL_CreateWindow("Space Shooter!",
                 SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
                 SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
@@ -48,20 +55,25 @@ WSL_App* wsl_init_sdl(void) {
         }
     }
 
-    // Create the renderer
-    if(success) {
+    // Create the renderer, or the framebuffer for the CPU backend
+    if(success && (backend == RB_CPU)) {
+        app->raster = wsl_raster_create(SCREEN_WIDTH, SCREEN_HEIGHT,
+                &app->stats);
+        if(!app->raster) success = false;
+    } else if(success && !headless) {
         app->renderer = SDL_CreateRenderer(app->window, -1,
                 SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
         if(!app->renderer) {
             printf("Renderer could not be created. SDL Error %s\n",
                     SDL_GetError());
             success = false;
+        } else {
+            SDL_SetRenderDrawColor(app->renderer, 0xFF, 0xFF, 0xFF, 0xFF);
         }
     }
 
     // Initialize SDL_Image
-    if(success) {
-        SDL_SetRenderDrawColor(app->renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    if(success && !headless) {
         if(!(IMG_Init(imgflags) & imgflags)) {
             printf("SDL Image could not initialize. SDL image error: %s\n",
                     IMG_GetError());
@@ -70,7 +82,7 @@ WSL_App* wsl_init_sdl(void) {
     }
 
     // Initialize SDL_ttf
-    if(success) {
+    if(success && !headless) {
         if(TTF_Init() == -1) {
             //TTF_Init returns 0 on success, -1 on failure
             printf("SDL_ttf could not initialize! SDL_ttf Error: %s\n",
@@ -80,7 +92,7 @@ WSL_App* wsl_init_sdl(void) {
     }
 
     // Initialize sound
-    if(success) {
+    if(success && !headless) {
         if(Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) == -1) {
             //Mix_OpenAudio returns 0 on success, -1 on failure
             printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n",
@@ -90,11 +102,11 @@ WSL_App* wsl_init_sdl(void) {
     }
 
     // Get the window surface
-    if(success) {
+    if(success && !headless) {
         app->screen_surface = SDL_GetWindowSurface(app->window);
     }
 
-    if(!wsl_load_media(app)) {
+    if(success && !headless && !wsl_load_media(app)) {
         success = false;
     }
 
@@ -105,18 +117,17 @@ WSL_App* wsl_init_sdl(void) {
     } else {
 
         app->running = true;
-        app->entities = NULL;
-        app->bgoffset = 0;
-        app->asteroidspawn = 50;
-        app->score = 0;
+        app->alpha = 1.0;
+        set_tick_rate(app, BASE_TICK_RATE);
+        app->asteroidspawn = secs_to_ticks(app, ASTEROID_SPAWN_FIRST);
         app->state = GS_MENU;
+        app->pool = wsl_pool_create(0); // One thread per CPU
+        if(app->raster && (wsl_pool_threads(app->pool) > 1)) {
+            // Tiles only pay off with someone to share them with
+            app->raster->pool = app->pool;
+        }
         app->scores = malloc(sizeof(Highscore) * NUM_HIGHSCORES);
         load_scores(app);
-        
-        // Set keyboard flags to false
-        for(i = 0; i < MAX_KEYBOARD_KEYS; i++) {
-            app->keyboard[i] = false;
-        }
     }
     
     return app;
@@ -127,11 +138,37 @@ void wsl_cleanup_sdl(WSL_App *app) {
     int i;
     if(!app) return;
 
+    // Finish any recording before the game's gone
+    replay_close(app->replay, app);
+    app->replay = NULL;
+    autopilot_destroy(app->autopilot);
+    app->autopilot = NULL;
+
+    // Cleanup entity list
+    while(app->entities) {
+        entity = app->entities;
+        app->entities = app->entities->next;
+        destroy_entity(entity);
+    }
+    free(app->particles);
+
+    // The pool's threads are SDL threads, done with before SDL is
+    wsl_pool_destroy(app->pool);
+    app->pool = NULL;
+
     // Cleanup SDL
-    destroy_wsl_texture(app->bg);
+    wsl_glyph_atlas_destroy(app->glyphs);
+    wsl_text_cache_destroy(app->textcache);
+    wsl_batch_destroy(app->batch);
+    wsl_render_queue_destroy(app->queue);
+    wsl_rot_cache_destroy(app->rotcache);
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        destroy_wsl_texture(app->bg[i].tex);
+    }
     destroy_wsl_texture(app->spritesheet);
     destroy_wsl_texture(app->hud_text);
-    SDL_DestroyRenderer(app->renderer);
+    wsl_raster_destroy(app->raster);
+    if(app->renderer) SDL_DestroyRenderer(app->renderer);
     app->renderer = NULL;
     SDL_DestroyWindow(app->window);
     app->window = NULL;
@@ -140,23 +177,18 @@ void wsl_cleanup_sdl(WSL_App *app) {
             Mix_FreeChunk(app->sounds[i]);
         }
     }
-    IMG_Quit();
-    TTF_CloseFont(app->font);
-    TTF_Quit();
-    Mix_Quit();
-    SDL_Quit();
-
-    // Cleanup entity list
-    while(app->entities) {
-        entity = app->entities;
-        app->entities = app->entities->next;
-        destroy_entity(entity);
+    if(app->backend != RB_HEADLESS) {
+        IMG_Quit();
+        TTF_CloseFont(app->font);
+        TTF_Quit();
+        Mix_Quit();
     }
 
-    // Save scores and then close them
-    save_scores(app);
+    // Save scores and then close them, headless runs don't count
+    if(app->backend != RB_HEADLESS) save_scores(app);
     close_scores(app);
 
+    SDL_Quit(); // Last, everything above may still be using SDL
     free(app);
 }
 
@@ -168,9 +200,7 @@ bool wsl_load_media(WSL_App *app) {
         printf("Unable to load assets/spritesheet.png!\n");
         success = false;
     }
-    app->bg = create_wsl_texture(app->renderer);
-    if(!wsl_texture_load(app->bg, "assets/black.png")) {
-        printf("Unable to load assets/black.png!\n");
+    if(!wsl_load_background(app)) {
         success = false;
     }
     app->font = TTF_OpenFont("assets/kenvector_future.ttf",FONT_SIZE);
@@ -179,6 +209,21 @@ bool wsl_load_media(WSL_App *app) {
         success = false;
     }
     app->hud_text = create_wsl_texture(app->renderer);
+    if(app->font) {
+        // Not fatal, text just goes the slow way without it
+        app->glyphs = wsl_glyph_atlas_create(app->renderer, app->font);
+        if(!app->glyphs) printf("Unable to build the glyph atlas!\n");
+    }
+    app->textcache = wsl_text_cache_create(TEXT_CACHE_BUDGET);
+    if(app->renderer) {
+        app->batch = wsl_batch_create(app->renderer, &app->stats);
+    }
+    app->queue = wsl_render_queue_create();
+    if((!app->batch && !app->raster) || !app->queue) {
+        printf("Unable to create the sprite batcher!\n");
+        success = false;
+    }
+    wsl_load_rot_cache(app);
 
     app->music = NULL;
     for(i = 0; i < SND_MAX; i++) {
@@ -206,6 +251,67 @@ bool wsl_load_media(WSL_App *app) {
     return success;
 }
 
+bool wsl_load_background(WSL_App *app) {
+    /*
+     * Load the background layers, bottom to top. The bottom layer is the
+     * plain starfield, the ones over it are drawn faintly and scroll at their
+     * own speed for a bit of parallax.
+     */
+    static const struct {
+        char *path;
+        float speed;
+        uint8_t alpha;
+    } layers[NUM_BG_LAYERS] = {
+        {"assets/black.png", 240, 255},
+        {"assets/darkPurple.png", 120, 48},
+        {"assets/blue.png", 360, 24}
+    };
+    bool success = true;
+    int i;
+    for(i = 0; i < NUM_BG_LAYERS; i++) {
+        app->bg[i].tex = create_wsl_texture(app->renderer);
+        app->bg[i].offset = 0;
+        app->bg[i].speed = layers[i].speed;
+        app->bg[i].alpha = layers[i].alpha;
+        if(!wsl_texture_load_tiled(app->bg[i].tex, layers[i].path,
+                    SCREEN_WIDTH, SCREEN_HEIGHT)) {
+            printf("Unable to load %s!\n", layers[i].path);
+            success = false;
+        }
+    }
+    return success;
+}
+
+void wsl_load_rot_cache(WSL_App *app) {
+    /*
+     * On the software renderer, pre-rotate the sprites that spin so they can
+     * be drawn as straight copies. Not fatal, they're just drawn turned the
+     * slow way without it.
+     */
+    static const SDL_Rect sprites[] = {
+        {224,664,101,84}, // Big asteroids (create_asteroid)
+        {0,520,120,98},
+        {518,810,89,82},
+        {327,452,98,96},
+        {651,447,43,43}, // meteorBrown_med1 (spawn_small_asteroid)
+        {237,452,45,40}, // meteorBrown_med3
+        {505,898,91,91}, // UFO
+        {628,681,25,24}, // star1, star2, star3 (particles)
+        {222,84,25,24},
+        {576,300,24,24},
+        {346,814,18,18}, // meteorBrown_tiny1, tiny2, small1, small2 (debris)
+        {399,814,16,15},
+        {406,234,28,28},
+        {778,587,29,26}
+    };
+    app->rotcache = NULL;
+    if(!wsl_renderer_is_software(app->renderer)) return;
+    app->rotcache = wsl_rot_cache_create(app->renderer,
+            "assets/spritesheet.png", sprites,
+            sizeof(sprites) / sizeof(sprites[0]));
+    if(!app->rotcache) printf("Unable to build the rotation cache!\n");
+}
+
 void wsl_load_music(WSL_App *app, char *filename) {
     if(app->music) {
         Mix_HaltMusic();
@@ -220,6 +326,8 @@ void wsl_play_music(WSL_App *app, int loop) {
 }
 
 void wsl_play_sound(WSL_App *app, int id, int channel) {
+    // No audio device, or the sound never loaded: nothing to play
+    if((app->backend == RB_HEADLESS) || !app->sounds[id]) return;
     if(Mix_PlayChannel(channel, app->sounds[id], 0) == -1) {
         printf("Unable to play sound: %d\n", id);
     }
@@ -228,6 +336,9 @@ void wsl_play_sound(WSL_App *app, int id, int channel) {
 void wsl_add_entity(WSL_App *app, Entity *entity) {
     Entity *e = NULL;
     if(!app || !entity) return;
+    // New entities don't have a last position to be drawn blended from
+    entity_snapshot(entity);
+    entity_update_aabb(entity);
     if(!app->entities) {
         // First entity in list!
         app->entities = entity;
@@ -286,6 +397,7 @@ void wsl_destroy_entity(WSL_App *app, Entity *entity) {
 WSL_Texture* create_wsl_texture(SDL_Renderer *renderer) {
     WSL_Texture *t = malloc(sizeof(WSL_Texture));
     t->tex = NULL;
+    t->pixels = NULL;
     t->w = 0;
     t->h = 0;
     t->renderer = renderer;
@@ -297,18 +409,72 @@ void destroy_wsl_texture(WSL_Texture *t) {
     if(t->tex) {
         SDL_DestroyTexture(t->tex);
     }
+    free(t->pixels);
     free(t);
     t = NULL;
 }
 
-bool wsl_texture_load(WSL_Texture *t, char *path) {
-    SDL_Surface *loaded = NULL;
-    
-    if(!t) return false;
+static void wsl_texture_unload(WSL_Texture *t) {
     if(t->tex) {
         SDL_DestroyTexture(t->tex);
         t->tex = NULL;
     }
+    free(t->pixels);
+    t->pixels = NULL;
+}
+
+bool wsl_texture_loaded(WSL_Texture *t) {
+    /* True if there's something to draw, on either backend */
+    return t && (t->tex || t->pixels);
+}
+
+bool wsl_texture_from_surface(WSL_Texture *t, SDL_Surface *surface) {
+    /*
+     * Replace whatever t held with the surface. With a renderer that's an
+     * SDL_Texture like always; without one (the CPU backend) the pixels are
+     * converted to premultiplied ARGB8888 and kept for WSL_Raster. The
+     * conversion turns a color key into alpha, same as SDL does for textures.
+     */
+    SDL_Surface *argb = NULL;
+    uint32_t *row = NULL;
+    uint32_t p, a;
+    int x, y;
+    if(!t || !surface) return false;
+    wsl_texture_unload(t);
+    if(t->renderer) {
+        t->tex = SDL_CreateTextureFromSurface(t->renderer, surface);
+        if(!t->tex) return false;
+    } else {
+        argb = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        if(!argb) return false;
+        t->pixels = malloc(sizeof(uint32_t) * argb->w * argb->h);
+        if(!t->pixels) {
+            SDL_FreeSurface(argb);
+            return false;
+        }
+        for(y = 0; y < argb->h; y++) {
+            row = (uint32_t*)((uint8_t*)argb->pixels + (y * argb->pitch));
+            for(x = 0; x < argb->w; x++) {
+                p = row[x];
+                a = p >> 24;
+                t->pixels[(y * argb->w) + x] = (a << 24) |
+                    ((((p >> 16) & 0xFF) * a / 255) << 16) |
+                    ((((p >> 8) & 0xFF) * a / 255) << 8) |
+                    ((p & 0xFF) * a / 255);
+            }
+        }
+        SDL_FreeSurface(argb);
+    }
+    t->w = surface->w;
+    t->h = surface->h;
+    return true;
+}
+
+bool wsl_texture_load(WSL_Texture *t, char *path) {
+    SDL_Surface *loaded = NULL;
+    
+    if(!t) return false;
+    wsl_texture_unload(t);
     
     loaded = IMG_Load(path);
     if(!loaded) {
@@ -324,19 +490,65 @@ bool wsl_texture_load(WSL_Texture *t, char *path) {
     }
 
     SDL_SetColorKey(loaded, SDL_TRUE, SDL_MapRGB(loaded->format, 0, 0xFF, 0xFF));
-    t->tex = SDL_CreateTextureFromSurface(t->renderer, loaded);
-    if(!t->tex) {
+    if(!wsl_texture_from_surface(t, loaded)) {
         printf("Unable to create texture from %s! SDL Error: %s\n", path,
                 SDL_GetError());
+        SDL_FreeSurface(loaded);
         return false;
     }
-    t->w = loaded->w;
-    t->h = loaded->h;
 
     SDL_FreeSurface(loaded);
     return true;
 }
 
+bool wsl_texture_load_tiled(WSL_Texture *t, char *path, int w, int h) {
+    /*
+     * Load an image and repeat it across a w x h texture, rounded up to whole
+     * tiles so the texture still wraps seamlessly top to bottom.
+     */
+    SDL_Surface *loaded = NULL;
+    SDL_Surface *tiled = NULL;
+    SDL_Rect dst = {0,0,0,0};
+
+    if(!t) return false;
+    wsl_texture_unload(t);
+
+    loaded = IMG_Load(path);
+    if(!loaded) {
+        printf("Unable to load image %s! SDL_image Error: %s\n",
+                path, IMG_GetError());
+        return false;
+    }
+    w = ((w + loaded->w - 1) / loaded->w) * loaded->w;
+    h = ((h + loaded->h - 1) / loaded->h) * loaded->h;
+    tiled = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32,
+            SDL_PIXELFORMAT_ARGB8888);
+    if(!tiled) {
+        printf("Unable to create a %dx%d surface for %s! SDL Error: %s\n",
+                w, h, path, SDL_GetError());
+        SDL_FreeSurface(loaded);
+        return false;
+    }
+
+    // Straight copy, no blending with the empty surface underneath
+    SDL_SetSurfaceBlendMode(loaded, SDL_BLENDMODE_NONE);
+    for(dst.y = 0; dst.y < h; dst.y += loaded->h) {
+        for(dst.x = 0; dst.x < w; dst.x += loaded->w) {
+            SDL_BlitSurface(loaded, NULL, tiled, &dst);
+        }
+    }
+    SDL_FreeSurface(loaded);
+
+    if(!wsl_texture_from_surface(t, tiled)) {
+        printf("Unable to create texture from %s! SDL Error: %s\n", path,
+                SDL_GetError());
+        SDL_FreeSurface(tiled);
+        return false;
+    }
+    SDL_FreeSurface(tiled);
+    return true;
+}
+
 bool wsl_texture_load_text(WSL_App *app, WSL_Texture *t, SDL_Color color, char *fstr, ...) {
     if(!fstr || !app) return false;
     va_list args;
@@ -361,27 +573,20 @@ bool wsl_texture_load_vtext(WSL_App *app, WSL_Texture *t, SDL_Color color, const
     vsnprintf(str,i,fstr,args); //Now that we know the size, write the string
 
     SDL_Surface *text_surface = NULL;
-    if(t->tex) {
-        SDL_DestroyTexture(t->tex);
-        t->tex = NULL;
-    }
+    wsl_texture_unload(t);
     text_surface = TTF_RenderUTF8_Solid(app->font, str, color);
     if(!text_surface) {
         printf("Error rendering text: \"%s\", SDL_Error: %s\n",
                 str, SDL_GetError());
     } else {
-        t->tex = SDL_CreateTextureFromSurface(app->renderer, text_surface);
-        if(!t->tex) {
+        if(!wsl_texture_from_surface(t, text_surface)) {
             printf("Unable to create texture from rendered text! SDL_Error: %s\n",
                     SDL_GetError());
-        } else {
-            t->w = text_surface->w;
-            t->h = text_surface->h;
         }
         SDL_FreeSurface(text_surface);
     }
     free(str);
-    return (t->tex != NULL);
+    return wsl_texture_loaded(t);
 }
 
 void wsl_ctext_render(WSL_App *app, SDL_Color color, int x, int y, char *fstr, ...) {
@@ -398,22 +603,68 @@ void wsl_ctext_render(WSL_App *app, SDL_Color color, int x, int y, char *fstr, .
         wsl_text_render(game, 20, 2, "Score: %d", game->score);
     */
     if(!app || !fstr) return;
-    if(!app->hud_text) return; //TODO: Need "default text" pointer in WSL_App
-    
     va_list args;
     va_start(args, fstr);
-    wsl_texture_load_vtext(app, app->hud_text, color, fstr, args);
+    wsl_vtext_render(app, color, x, y, fstr, args);
     va_end(args);
-    wsl_texture_render(app->hud_text,x,y);
 }
 
 void wsl_text_render(WSL_App *app, int x, int y, char *fstr, ...) {
     SDL_Color color = {255,255,255,255}; //Default text color is white
+    if(!app || !fstr) return;
     va_list args;
     va_start(args, fstr);
-    wsl_texture_load_vtext(app, app->hud_text, color, fstr, args);
+    wsl_vtext_render(app, color, x, y, fstr, args);
     va_end(args);
-    wsl_texture_render(app->hud_text,x,y);
+}
+
+void wsl_vtext_render(WSL_App *app, SDL_Color color, int x, int y,
+        const char *fstr, va_list args) {
+    /*
+     * Format the string and draw it from the glyph atlas. Anything the atlas
+     * can't handle (no atlas, characters outside of printable ASCII) comes out
+     * of the text cache instead, and only if there's no cache either does it
+     * get rendered into one of the queue's scratch textures. Every path goes
+     * through the queue, so text always lands in RL_HUD order.
+     */
+    char buf[256];
+    char *str = buf;
+    int len = 0;
+    WSL_Texture *t = NULL;
+    SDL_Rect dst;
+    SDL_Color white = {255,255,255,255}; // Already rendered in color
+    va_list args_copy;
+    va_copy(args_copy, args);
+    len = vsnprintf(buf, sizeof(buf), fstr, args_copy);
+    va_end(args_copy);
+    if(len < 0) return;
+    if(len >= (int)sizeof(buf)) {
+        // Doesn't fit on the stack
+        str = malloc(len + 1);
+        if(!str) return;
+        va_copy(args_copy, args);
+        vsnprintf(str, len + 1, fstr, args_copy);
+        va_end(args_copy);
+    }
+
+    if(!wsl_glyph_atlas_render(app->glyphs, app->queue, RL_HUD, color, x, y,
+                str)) {
+        t = wsl_text_cache_get(app, app->textcache, color, str);
+        if(t) {
+            dst = (SDL_Rect){x, y, t->w, t->h};
+            wsl_render_sprite(app->queue, RL_HUD, t, SDL_BLENDMODE_BLEND,
+                    NULL, &dst, 0, white);
+        } else {
+            // A texture of its own for this frame, so it queues like the rest
+            t = wsl_render_queue_scratch(app->queue, app->renderer);
+            if(t && wsl_texture_load_text(app, t, color, "%s", str)) {
+                dst = (SDL_Rect){x, y, t->w, t->h};
+                wsl_render_sprite(app->queue, RL_HUD, t, SDL_BLENDMODE_BLEND,
+                        NULL, &dst, 0, white);
+            }
+        }
+    }
+    if(str != buf) free(str);
 }
 
 void wsl_texture_render(WSL_Texture *t, int x, int y) {
@@ -0,0 +1,288 @@
+/*
+* Space Shooter
+* Copyright (C) Zach Wilder 2024
+* 
+* This file is a part of Space Shooter
+*
+* Space Shooter is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* Space Shooter is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with Space Shooter.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <spaceshooter.h>
+
+#define ATLAS_WIDTH 512 // Glyphs are packed into rows this wide
+
+/*****
+ * WSL_GlyphAtlas
+ *****/
+WSL_GlyphAtlas* wsl_glyph_atlas_create(SDL_Renderer *renderer, TTF_Font *font) {
+    /*
+     * Render every printable ASCII glyph once, in white, into a single
+     * texture. Text is then drawn as one sprite per glyph, tinted with the
+     * vertex color, so nothing gets rasterized or uploaded per frame.
+     */
+    WSL_GlyphAtlas *atlas = NULL;
+    SDL_Surface *glyphs[GLYPH_COUNT] = {NULL};
+    SDL_Surface *sheet = NULL;
+    SDL_Color white = {255,255,255,255};
+    SDL_Rect dst;
+    int i, x = 0, y = 0, rowh = 0;
+    bool success = true;
+
+    if(!font) return NULL;
+    atlas = malloc(sizeof(WSL_GlyphAtlas));
+    if(!atlas) return NULL;
+    atlas->tex = NULL;
+    atlas->font = font;
+    atlas->height = TTF_FontHeight(font);
+
+    // Render the glyphs and work out where each one goes
+    for(i = 0; i < GLYPH_COUNT && success; i++) {
+        glyphs[i] = TTF_RenderGlyph_Solid(font, GLYPH_FIRST + i, white);
+        if(!glyphs[i]) {
+            printf("Unable to render glyph %d! SDL_ttf Error: %s\n",
+                    GLYPH_FIRST + i, TTF_GetError());
+            success = false;
+            break;
+        }
+        if(TTF_GlyphMetrics(font, GLYPH_FIRST + i, NULL, NULL, NULL, NULL,
+                    &atlas->glyphs[i].advance) == -1) {
+            atlas->glyphs[i].advance = glyphs[i]->w;
+        }
+        if(x + glyphs[i]->w > ATLAS_WIDTH) {
+            x = 0;
+            y += rowh;
+            rowh = 0;
+        }
+        atlas->glyphs[i].rect.x = x;
+        atlas->glyphs[i].rect.y = y;
+        atlas->glyphs[i].rect.w = glyphs[i]->w;
+        atlas->glyphs[i].rect.h = glyphs[i]->h;
+        x += glyphs[i]->w;
+        if(glyphs[i]->h > rowh) rowh = glyphs[i]->h;
+    }
+
+    // Copy them all onto one transparent sheet and upload it
+    if(success) {
+        sheet = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, y + rowh, 32,
+                SDL_PIXELFORMAT_RGBA32);
+        if(!sheet) {
+            printf("Unable to create glyph atlas surface! SDL Error: %s\n",
+                    SDL_GetError());
+            success = false;
+        }
+    }
+    if(success) {
+        SDL_FillRect(sheet, NULL, SDL_MapRGBA(sheet->format, 0, 0, 0, 0));
+        for(i = 0; i < GLYPH_COUNT; i++) {
+            dst = atlas->glyphs[i].rect;
+            SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(glyphs[i], NULL, sheet, &dst);
+        }
+        atlas->tex = create_wsl_texture(renderer);
+        if(!wsl_texture_from_surface(atlas->tex, sheet)) {
+            printf("Unable to create glyph atlas texture! SDL Error: %s\n",
+                    SDL_GetError());
+            success = false;
+        } else if(atlas->tex->tex) {
+            SDL_SetTextureBlendMode(atlas->tex->tex, SDL_BLENDMODE_BLEND);
+        }
+    }
+
+    for(i = 0; i < GLYPH_COUNT; i++) {
+        if(glyphs[i]) SDL_FreeSurface(glyphs[i]);
+    }
+    if(sheet) SDL_FreeSurface(sheet);
+    if(!success) {
+        wsl_glyph_atlas_destroy(atlas);
+        atlas = NULL;
+    }
+    return atlas;
+}
+
+void wsl_glyph_atlas_destroy(WSL_GlyphAtlas *atlas) {
+    if(!atlas) return;
+    destroy_wsl_texture(atlas->tex);
+    free(atlas);
+}
+
+bool wsl_glyph_atlas_covers(WSL_GlyphAtlas *atlas, const char *str) {
+    /* True if every character in str has a glyph in the atlas */
+    const unsigned char *c = (const unsigned char*)str;
+    if(!atlas || !str) return false;
+    for(; *c; c++) {
+        if(*c < GLYPH_FIRST || *c > GLYPH_LAST) return false;
+    }
+    return true;
+}
+
+bool wsl_glyph_atlas_render(WSL_GlyphAtlas *atlas, WSL_RenderQueue *queue,
+        int layer, SDL_Color color, int x, int y, const char *str) {
+    /*
+     * Queue str on a layer with its top left corner at x,y, one sprite per
+     * glyph. Returns false (and queues nothing) if the atlas can't draw the
+     * whole string.
+     */
+    SDL_Rect dst;
+    WSL_Glyph *g = NULL;
+    const unsigned char *c = (const unsigned char*)str;
+    int penx = x;
+    unsigned char prev = 0;
+
+    if(!queue || !wsl_glyph_atlas_covers(atlas, str)) return false;
+    for(; *c; c++) {
+        if(prev) penx += TTF_GetFontKerningSizeGlyphs(atlas->font, prev, *c);
+        prev = *c;
+        g = &atlas->glyphs[*c - GLYPH_FIRST];
+        if(*c != ' ') {
+            dst = (SDL_Rect){penx, y, g->rect.w, g->rect.h};
+            wsl_render_sprite(queue, layer, atlas->tex, SDL_BLENDMODE_BLEND,
+                    &g->rect, &dst, 0, color);
+        }
+        penx += g->advance;
+    }
+    return true;
+}
+
+/*****
+ * WSL_TextCache
+ *****/
+static uint32_t text_cache_hash(const char *str, SDL_Color color,
+        TTF_Font *font) {
+    /* FNV-1a over the string, then the color and font */
+    uint32_t h = 2166136261u;
+    uintptr_t f = (uintptr_t)font;
+    for(; *str; str++) {
+        h = (h ^ (unsigned char)*str) * 16777619u;
+    }
+    h = (h ^ color.r) * 16777619u;
+    h = (h ^ color.g) * 16777619u;
+    h = (h ^ color.b) * 16777619u;
+    h = (h ^ color.a) * 16777619u;
+    h = (h ^ (uint32_t)(f >> 4)) * 16777619u;
+    return h;
+}
+
+static void text_cache_unlink(WSL_TextCache *cache, WSL_TextCacheEntry *e) {
+    /* Take e out of the LRU list (it stays in its bucket) */
+    if(e->prev) e->prev->next = e->next;
+    else cache->head = e->next;
+    if(e->next) e->next->prev = e->prev;
+    else cache->tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void text_cache_push_front(WSL_TextCache *cache, WSL_TextCacheEntry *e) {
+    e->prev = NULL;
+    e->next = cache->head;
+    if(cache->head) cache->head->prev = e;
+    cache->head = e;
+    if(!cache->tail) cache->tail = e;
+}
+
+static void text_cache_evict(WSL_TextCache *cache, WSL_TextCacheEntry *e) {
+    /* Drop e from the cache and free it */
+    WSL_TextCacheEntry **link = &cache->buckets[e->hash & (TEXT_CACHE_BUCKETS-1)];
+    while(*link && (*link != e)) link = &(*link)->chain;
+    if(*link) *link = e->chain;
+    text_cache_unlink(cache, e);
+    cache->bytes -= e->bytes;
+    cache->count -= 1;
+    destroy_wsl_texture(e->tex);
+    free(e->str);
+    free(e);
+}
+
+WSL_TextCache* wsl_text_cache_create(size_t budget) {
+    /* Cache of rendered strings, holding at most budget bytes of pixels */
+    WSL_TextCache *cache = calloc(1, sizeof(WSL_TextCache));
+    if(!cache) return NULL;
+    cache->budget = budget;
+    return cache;
+}
+
+void wsl_text_cache_clear(WSL_TextCache *cache) {
+    if(!cache) return;
+    while(cache->tail) text_cache_evict(cache, cache->tail);
+}
+
+void wsl_text_cache_next_frame(WSL_TextCache *cache) {
+    /* Called once a frame has been drawn */
+    if(cache) cache->frame += 1;
+}
+
+void wsl_text_cache_destroy(WSL_TextCache *cache) {
+    if(!cache) return;
+    wsl_text_cache_clear(cache);
+    free(cache);
+}
+
+WSL_Texture* wsl_text_cache_get(WSL_App *app, WSL_TextCache *cache,
+        SDL_Color color, const char *str) {
+    /*
+     * Find str in the cache (same string, color and font), rendering it on a
+     * miss. Whatever is used goes to the front of the list, and the least
+     * recently used strings are thrown out once the cache is over budget (but
+     * not ones used this frame). Returns NULL if the text couldn't be
+     * rendered.
+     */
+    uint32_t h = 0;
+    WSL_TextCacheEntry *e = NULL;
+    if(!app || !cache || !str) return NULL;
+    h = text_cache_hash(str, color, app->font);
+    for(e = cache->buckets[h & (TEXT_CACHE_BUCKETS-1)]; e; e = e->chain) {
+        if((e->hash == h) && (e->font == app->font) &&
+                (e->color.r == color.r) && (e->color.g == color.g) &&
+                (e->color.b == color.b) && (e->color.a == color.a) &&
+                (strcmp(e->str, str) == 0)) {
+            cache->hits += 1;
+            e->used = cache->frame;
+            text_cache_unlink(cache, e);
+            text_cache_push_front(cache, e);
+            return e->tex;
+        }
+    }
+
+    // Miss, render it and keep it
+    cache->misses += 1;
+    e = malloc(sizeof(WSL_TextCacheEntry));
+    if(!e) return NULL;
+    e->str = malloc(strlen(str) + 1);
+    e->tex = create_wsl_texture(app->renderer);
+    if(!e->str || !e->tex || 
+            !wsl_texture_load_text(app, e->tex, color, "%s", str)) {
+        destroy_wsl_texture(e->tex);
+        free(e->str);
+        free(e);
+        return NULL;
+    }
+    strcpy(e->str, str);
+    e->color = color;
+    e->font = app->font;
+    e->hash = h;
+    e->used = cache->frame;
+    e->bytes = (size_t)e->tex->w * e->tex->h * 4;
+    e->chain = cache->buckets[h & (TEXT_CACHE_BUCKETS-1)];
+    cache->buckets[h & (TEXT_CACHE_BUCKETS-1)] = e;
+    text_cache_push_front(cache, e);
+    cache->bytes += e->bytes;
+    cache->count += 1;
+
+    // Over budget, drop from the back. Strings used this frame may still be
+    // sitting in the render queue, so those stay (over budget) until the next.
+    while((cache->bytes > cache->budget) && (cache->tail->used != cache->frame)) {
+        text_cache_evict(cache, cache->tail);
+        cache->evictions += 1;
+    }
+    return e->tex;
+}